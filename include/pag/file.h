@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include "pag/types.h"
@@ -313,37 +314,28 @@ class AnimatableProperty : public Property<T> {
   }
 
   T getValueAt(Frame frame) override {
-    T result;
-    size_t lastKeyframeIndexInternal = lastKeyframeIndex;
-    Keyframe<T>* lastKeyframe = keyframes[lastKeyframeIndexInternal];
-    if (lastKeyframe->containsTime(frame)) {
-      return lastKeyframe->getValueAt(frame);
+    // The cached index is only a hint. Threads evaluating the same property at once may overwrite
+    // each other's hint, which costs a lookup but never affects the result.
+    auto index = lastKeyframeIndex.load(std::memory_order_relaxed);
+    auto keyframe = keyframes[index];
+    if (keyframe->containsTime(frame)) {
+      return keyframe->getValueAt(frame);
     }
-    if (frame < lastKeyframe->startTime) {
-      while (lastKeyframeIndexInternal > 0) {
-        lastKeyframeIndexInternal--;
-        if (keyframes[lastKeyframeIndexInternal]->containsTime(frame)) {
-          break;
-        }
-      }
+    if (index + 1 < keyframes.size() && keyframes[index + 1]->containsTime(frame)) {
+      // Sequential playback usually steps into the next keyframe.
+      index++;
     } else {
-      while (lastKeyframeIndexInternal < keyframes.size() - 1) {
-        lastKeyframeIndexInternal++;
-        if (keyframes[lastKeyframeIndexInternal]->containsTime(frame)) {
-          break;
-        }
-      }
+      index = findKeyframeIndex(frame);
     }
-    lastKeyframe = keyframes[lastKeyframeIndexInternal];
-    if (frame <= lastKeyframe->startTime) {
-      result = lastKeyframe->startValue;
-    } else if (frame >= lastKeyframe->endTime) {
-      result = lastKeyframe->endValue;
-    } else {
-      result = lastKeyframe->getValueAt(frame);
+    keyframe = keyframes[index];
+    lastKeyframeIndex.store(index, std::memory_order_relaxed);
+    if (frame <= keyframe->startTime) {
+      return keyframe->startValue;
+    }
+    if (frame >= keyframe->endTime) {
+      return keyframe->endValue;
     }
-    lastKeyframeIndex = lastKeyframeIndexInternal;
-    return result;
+    return keyframe->getValueAt(frame);
   }
 
   /**
@@ -354,6 +346,20 @@ class AnimatableProperty : public Property<T> {
  private:
   std::atomic_size_t lastKeyframeIndex;
 
+  /**
+   * Returns the index of the last keyframe starting at or before the frame, or 0 if the frame is
+   * before the first keyframe. Keyframes are sorted by their start times.
+   */
+  size_t findKeyframeIndex(Frame frame) const {
+    auto position = std::upper_bound(
+        keyframes.begin(), keyframes.end(), frame,
+        [](Frame time, const Keyframe<T>* keyframe) { return time < keyframe->startTime; });
+    if (position == keyframes.begin()) {
+      return 0;
+    }
+    return static_cast<size_t>(position - keyframes.begin()) - 1;
+  }
+
   RTTR_ENABLE(Property<T>)
 };
 
@@ -1848,7 +1854,7 @@ class PAG_API Layer {
   std::vector<Marker*> markers;
   Enum cachePolicy = CachePolicy::Auto;
 
-  Cache* cache = nullptr;
+  std::atomic<Cache*> cache = {nullptr};
   std::mutex locker = {};
 
   virtual void excludeVaryingRanges(std::vector<TimeRange>* timeRanges);
@@ -2069,7 +2075,7 @@ class PAG_API Composition {
    * [FrameStart, FrameEnd(included)], [FrameStar, FrameEnd]...
    */
   std::vector<TimeRange> staticTimeRanges;
-  Cache* cache = nullptr;
+  std::atomic<Cache*> cache = {nullptr};
   std::mutex locker = {};
 
   bool staticContent() const;
@@ -2165,7 +2171,7 @@ class PAG_API ImageBytes {
 
   bool verify() const;
 
-  Cache* cache = nullptr;
+  std::atomic<Cache*> cache = {nullptr};
   std::mutex locker = {};
 
  private:
@@ -2324,6 +2330,12 @@ class PAG_API VideoSequence : public Sequence {
    * Codec specific data.
    */
   std::vector<ByteData*> headers;
+  /**
+   * Indicates whether the fileBytes of each video frame begins with a 4-byte start code or AVCC
+   * length prefix. It is false if the frames refer to the original file bytes directly, in which
+   * case the prefix is written when the frame is submitted to the video decoder.
+   */
+  bool hasFrameStartCodes = true;
 
   std::vector<TimeRange> staticTimeRanges;
 
@@ -2428,7 +2440,9 @@ class PAG_API File {
                                     const std::string& password = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. The file is mapped into memory and shared by the returned File, so it must not be
+   * truncated or rewritten while the File is alive, see ByteData::FromPathMapped(). Load the file
+   * from bytes instead if it may be modified by other processes.
    */
   static std::shared_ptr<File> Load(const std::string& filePath, const std::string& password = "");
 
@@ -2550,6 +2564,18 @@ class PAG_API Codec {
    */
   static uint16_t MaxSupportedTagLevel();
 
+  /**
+   * Returns true if the images and compositions of a pag file are decoded concurrently on multiple
+   * threads. The default value is false.
+   */
+  static bool ParallelDecodingEnabled();
+
+  /**
+   * Set whether the images and compositions of a pag file are decoded concurrently on multiple
+   * threads. It can reduce the loading time of large files that contain many compositions.
+   */
+  static void SetParallelDecodingEnabled(bool value);
+
   /**
    * Replace all temporary mask with real references.
    */
@@ -2578,6 +2604,14 @@ class PAG_API Codec {
   static std::shared_ptr<File> Decode(const void* bytes, uint32_t byteLength,
                                       const std::string& path);
 
+  /**
+   * Decode a pag file from the specified byte data and keep a reference to it, so that large
+   * payloads such as video frames can refer to the byte data directly instead of being copied.
+   * Return null if the bytes is empty or it's not a valid pag file.
+   */
+  static std::shared_ptr<File> Decode(std::shared_ptr<ByteData> fileBytes,
+                                      const std::string& path);
+
   /**
    * Encode a pag file to byte data, return null if the file is null.
    */
@@ -2598,6 +2632,9 @@ class PAG_API Codec {
                                                               uint32_t byteLength);
 
  protected:
+  static std::shared_ptr<File> Decode(CodecContext* context, const void* bytes,
+                                      uint32_t byteLength, const std::string& path);
+
   static void UpdateFileAttributes(std::shared_ptr<File> file, CodecContext* context,
                                    const std::string& filePath);
 };
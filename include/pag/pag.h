@@ -39,6 +39,12 @@ class RenderCache;
 
 class Drawable;
 
+class PixelBufferDrawable;
+
+class VaryingTimeRanges;
+
+class DamageTracker;
+
 class Content {
  public:
   virtual ~Content() = default;
@@ -105,6 +111,25 @@ class PAG_API PAGImage {
    */
   static std::shared_ptr<PAGImage> FromTexture(const BackendTexture& texture, ImageOrigin origin);
 
+  /**
+   * Creates an animated PAGImage object from the image files (png, jpg, jpeg and webp) in the
+   * specified directory, one file per frame, sorted by their file names. All the images should have
+   * the same size. Returns null if there is no valid image file in the directory or the frameRate
+   * is not positive. When the returned image replaces an image layer, its frames are mapped to the
+   * layer time through the content time remap of the layer, and the frames following the
+   * current one are decoded ahead in background threads.
+   */
+  static std::shared_ptr<PAGImage> FromImageSequence(const std::string& directory,
+                                                     float frameRate);
+
+  /**
+   * Creates an animated PAGImage object from the path of an MP4 file with an H.264 video track.
+   * Returns null if the file does not exist, or it has no H.264 video track. The frames are decoded
+   * by the registered video decoders and follow the content time remap of the replaced image layer,
+   * the same as the images created by FromImageSequence().
+   */
+  static std::shared_ptr<PAGImage> FromVideoPath(const std::string& filePath);
+
   virtual ~PAGImage() = default;
 
   /**
@@ -222,6 +247,18 @@ class PAG_API PAGFont {
   static void SetFallbackFontPaths(const std::vector<std::string>& fontPaths,
                                    const std::vector<int>& ttcIndices);
 
+  /**
+   * Returns the maximum number of fonts kept by the text shaper for reuse. The default value is
+   * 100. Returns 0 if the text shaper does not cache fonts on the current platform.
+   */
+  static size_t MaxShapingFontCount();
+
+  /**
+   * Sets the maximum number of fonts kept by the text shaper for reuse. Raise it if the pag files
+   * use a large number of fonts at the same time. Set it to 0 to disable the reuse.
+   */
+  static void SetMaxShapingFontCount(size_t count);
+
   PAGFont(std::string fontFamily, std::string fontStyle)
       : fontFamily(std::move(fontFamily)), fontStyle(std::move(fontStyle)) {
   }
@@ -458,6 +495,13 @@ class PAG_API PAGLayer : public Content {
   void preFrameInternal();
   void nextFrameInternal();
   virtual bool gotoTime(int64_t layerTime);
+  /**
+   * Adds this layer and its sublayers to timeRanges, shifted by timeOffset, so that the changes
+   * reported by gotoTime() can be found without visiting every frame. Returns false if the content
+   * can not be described by the static time ranges of the layer caches, in which case the caller
+   * needs to step through the frames with gotoTime().
+   */
+  virtual bool collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges);
   virtual Frame childFrameToLocal(Frame childFrame, float childFrameRate) const;
   virtual Frame localFrameToChild(Frame localFrame, float childFrameRate) const;
 
@@ -532,6 +576,8 @@ class PAG_API PAGLayer : public Content {
   friend class ContentVersion;
 
   friend class PAGDecoder;
+
+  friend class DamageTracker;
 };
 
 class SolidLayer;
@@ -777,6 +823,7 @@ class PAG_API PAGImageLayer : public PAGLayer {
 
  protected:
   bool gotoTime(int64_t layerTime) override;
+  bool collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) override;
   void setImageInternal(std::shared_ptr<PAGImage> image);
   int64_t getCurrentContentTime(int64_t layerTime);
   Property<float>* getContentTimeRemap();
@@ -816,6 +863,8 @@ class PAG_API PAGImageLayer : public PAGLayer {
   friend class PAGFile;
 
   friend class AudioClip;
+
+  friend class DamageTracker;
 };
 
 class PreComposeLayer;
@@ -957,6 +1006,7 @@ class PAG_API PAGComposition : public PAGLayer {
       std::function<bool(PAGLayer* pagLayer)> filterFunc);
   float frameRateInternal() const override;
   bool gotoTime(int64_t layerTime) override;
+  bool collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) override;
   Frame childFrameToLocal(Frame childFrame, float childFrameRate) const override;
   Frame localFrameToChild(Frame localFrame, float childFrameRate) const override;
   int widthInternal() const;
@@ -997,6 +1047,7 @@ class PAG_API PAGComposition : public PAGLayer {
   void doSetLayerIndex(std::shared_ptr<PAGLayer> pagLayer, int index);
   bool doContains(PAGLayer* layer) const;
   void updateDurationAndFrameRate();
+  int64_t childTimeOffset() const;
 
   friend class PAGLayer;
 
@@ -1015,6 +1066,8 @@ class PAG_API PAGComposition : public PAGLayer {
   friend class AudioClip;
 
   friend class PAGDecoder;
+
+  friend class DamageTracker;
 };
 
 class PAG_API PAGFile : public PAGComposition {
@@ -1032,7 +1085,9 @@ class PAG_API PAGFile : public PAGComposition {
                                        const std::string& password = "");
   /**
    *  Load a pag file from path, return null if the file does not exist or the data is not a pag
-   * file.
+   * file. The file is mapped into memory while the PAGFile is alive, so it must not be truncated
+   * or rewritten in the meantime. Load the file from bytes instead if it may be modified by other
+   * processes.
    */
   static std::shared_ptr<PAGFile> Load(const std::string& filePath,
                                        const std::string& password = "");
@@ -1129,6 +1184,7 @@ class PAG_API PAGFile : public PAGComposition {
 
  protected:
   bool gotoTime(int64_t layerTime) override;
+  bool collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) override;
   Frame childFrameToLocal(Frame childFrame, float childFrameRate) const override;
   Frame localFrameToChild(Frame localFrame, float childFrameRate) const override;
   std::vector<std::shared_ptr<PAGLayer>> getLayersByEditableIndexInternal(int editableIndex,
@@ -1150,6 +1206,7 @@ class PAG_API PAGFile : public PAGComposition {
                            std::shared_ptr<TextDocument> textData);
   void replaceImageInternal(const std::vector<std::shared_ptr<PAGLayer>>& imageLayers,
                             std::shared_ptr<PAGImage> image);
+  std::shared_ptr<PAGFile> copyWithEdits();
 
   Frame _stretchedContentFrame = 0;
   Frame _stretchedFrameDuration = 1;
@@ -1160,6 +1217,10 @@ class PAG_API PAGFile : public PAGComposition {
   friend class LayerRenderer;
 
   friend class AudioClip;
+
+  friend class PAGDecoder;
+
+  friend class PAGBatchRenderer;
 };
 
 class Composition;
@@ -1200,6 +1261,23 @@ class PAG_API PAGSurface {
    */
   static std::shared_ptr<PAGSurface> MakeOffscreen(int width, int height);
 
+  /**
+   * Creates a new PAGSurface for off-screen rendering into caller-owned pixel buffers. Every
+   * flush() that changes the content writes the frame directly into the next buffer of the ring
+   * and then calls frameReady with the index of that buffer on the flushing thread. The buffer
+   * belongs to the caller until it is passed to releaseBuffer(), so the next frame can be rendered
+   * while the caller consumes the previous one. If the next buffer has not been released yet,
+   * flush() waits until it is. If frameReady is nullptr, buffers are released immediately. Every
+   * buffer must hold at least height * rowBytes bytes and stay valid as long as the PAGSurface.
+   * Returns null if the size or any of the buffers is not valid.
+   */
+  static std::shared_ptr<PAGSurface> MakeOffscreen(int width, int height,
+                                                   const std::vector<void*>& buffers,
+                                                   size_t rowBytes,
+                                                   std::function<void(int bufferIndex)> frameReady,
+                                                   ColorType colorType = ColorType::RGBA_8888,
+                                                   AlphaType alphaType = AlphaType::Premultiplied);
+
   /**
    * Creates a new PAGSurface from specified hardware buffer. Returns null if the hardware buffer
    * is invalid.
@@ -1247,6 +1325,28 @@ class PAG_API PAGSurface {
    */
   bool readPixels(ColorType colorType, AlphaType alphaType, void* dstPixels, size_t dstRowBytes);
 
+  /**
+   * Copies the pixels inside srcRect from current PAGSurface to dstPixels with specified color
+   * type, alpha type and row bytes. The rectangle is in pixels and is rounded out to whole pixels,
+   * which makes it possible to read back only the damagedBounds() of the last flush. Returns false
+   * if the rectangle does not intersect the PAGSurface.
+   */
+  bool readPixels(ColorType colorType, AlphaType alphaType, void* dstPixels, size_t dstRowBytes,
+                  const Rect& srcRect);
+
+  /**
+   * Returns the rectangle in pixels that was redrawn by the last flush() of the PAGPlayer, which is
+   * the whole PAGSurface unless PAGPlayer.incrementalRendering is enabled. Returns an empty
+   * rectangle if nothing has been drawn since the PAGSurface was created or cleared.
+   */
+  Rect damagedBounds();
+
+  /**
+   * Returns the buffer at the given index to a PAGSurface created from caller-owned pixel buffers,
+   * so that it can be written by a later flush(). Does nothing for other kinds of PAGSurface.
+   */
+  void releaseBuffer(int bufferIndex);
+
  protected:
   explicit PAGSurface(std::shared_ptr<Drawable> drawable, bool externalContext = false);
 
@@ -1259,11 +1359,14 @@ class PAG_API PAGSurface {
   PAGPlayer* pagPlayer = nullptr;
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<Drawable> drawable = nullptr;
+  PixelBufferDrawable* pixelBufferDrawable = nullptr;
   bool externalContext = false;
   GLRestorer* glRestorer = nullptr;
+  std::weak_ptr<tgfx::Surface> lastSurface;
+  Rect lastDamagedBounds = Rect::MakeEmpty();
 
   bool draw(RenderCache* cache, std::shared_ptr<Graphic> graphic, BackendSemaphore* signalSemaphore,
-            bool autoClear = true);
+            bool autoClear = true, const tgfx::Rect* damagedRegion = nullptr);
   bool prepare(RenderCache* cache, std::shared_ptr<Graphic> graphic);
   bool hitTest(RenderCache* cache, std::shared_ptr<Graphic> graphic, float x, float y);
   tgfx::Context* lockContext();
@@ -1437,6 +1540,20 @@ class PAG_API PAGPlayer {
    */
   void setAutoClear(bool value);
 
+  /**
+   * If true, PAGPlayer tracks which layers have changed since the last flush and only clears and
+   * redraws the changed region of the PAGSurface, which can be queried by
+   * PAGSurface.damagedBounds(). It takes effect only when autoClear is true and the PAGSurface
+   * keeps its pixels between frames, such as an offscreen surface or a surface made from a texture
+   * or a hardware buffer. Other surfaces are still redrawn as a whole. The default value is false.
+   */
+  bool incrementalRendering();
+
+  /**
+   * Sets the incrementalRendering property.
+   */
+  void setIncrementalRendering(bool value);
+
   /**
    * Prepares the player for the next flush() call. It collects all CPU tasks from the current
    * progress of the composition and runs them asynchronously in parallel. It is usually used for
@@ -1527,6 +1644,48 @@ class PAG_API PAGPlayer {
    */
   int64_t graphicsMemory();
 
+  /**
+   * Returns the soft limit of the graphics memory in bytes. Once the memory usage of this player
+   * exceeds it, the caches unused for a few frames are purged at the end of every frame. The
+   * default value is PAGGraphicsMemory::DefaultSoftLimit().
+   */
+  size_t softMemoryLimit();
+
+  /**
+   * Sets the soft limit of the graphics memory in bytes.
+   */
+  void setSoftMemoryLimit(size_t bytes);
+
+  /**
+   * Returns the hard limit of the graphics memory in bytes. No new caches are created once the
+   * memory usage of this player reaches it, and the caches are purged at the end of every frame
+   * to keep the memory usage under it, even if they are still in use. The default value is
+   * PAGGraphicsMemory::DefaultHardLimit().
+   */
+  size_t hardMemoryLimit();
+
+  /**
+   * Sets the hard limit of the graphics memory in bytes.
+   */
+  void setHardMemoryLimit(size_t bytes);
+
+  /**
+   * Purges the internal caches of this player, such as snapshots, text atlases, decoded images and
+   * video sequences, until the specified number of bytes is released or nothing else can be
+   * purged. The caches unused in the last frame are purged first. Returns the released bytes.
+   * Nothing is purged if the player has no surface or the GPU context of the surface is not
+   * available, since most of the caches hold GPU resources.
+   */
+  size_t purgeCache(size_t bytes);
+
+  /**
+   * Sets a callback which is notified after a flush if the memory usage of this player still
+   * exceeds the soft limit after purging the caches down to the hard limit and
+   * PAGGraphicsMemory::MaxTotalMemory(). The callback is called on the flushing thread with the current memory usage in
+   * bytes, after the player is unlocked.
+   */
+  void setMemoryPressureCallback(std::function<void(size_t memoryUsage)> callback);
+
  protected:
   std::shared_ptr<std::mutex> rootLocker = nullptr;
   std::shared_ptr<PAGStage> stage = nullptr;
@@ -1540,15 +1699,18 @@ class PAG_API PAGPlayer {
 
  private:
   FileReporter* reporter = nullptr;
+  std::function<void(size_t memoryUsage)> memoryPressureCallback = nullptr;
   float _maxFrameRate = 60;
   int _scaleMode = PAGScaleMode::LetterBox;
   bool _autoClear = true;
+  DamageTracker* damageTracker = nullptr;
 
   bool updateStageSize();
   void setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface);
   int64_t getTimeStampInternal();
   void prepareInternal();
   int64_t durationInternal();
+  bool flushAndNotify(BackendSemaphore* signalSemaphore);
 
   friend class PAGSurface;
 };
@@ -1626,6 +1788,24 @@ class PAG_API PAGDecoder {
    */
   bool readFrame(int index, HardwareBufferRef hardwareBuffer);
 
+  /**
+   * Reads the image frames in the range [startIndex, endIndex) and passes their pixels to the
+   * callback in ascending index order. The frames are rendered concurrently by up to maxWorkers
+   * threads, each of which renders its own copy of the associated PAGComposition, and at most two
+   * rendered frames per worker are kept ahead of the callback. Frames within the same static time
+   * range are rendered only once. Passing a value less than or equal to 0 for maxWorkers uses the
+   * number of available CPU cores. The pixels passed to the callback are only valid until the
+   * callback returns, return false from the callback to stop reading. Concurrent rendering
+   * requires the associated PAGComposition to be a PAGFile without any added or removed layers and
+   * without any time-varying PAGImage replacements, otherwise, the frames are rendered one by one on
+   * the calling thread. Returns false if any frame fails to be read. Note that caller must ensure that colorType, alphaType, and dstRowBytes stay
+   * the same as the readFrame() calls.
+   */
+  bool readFrames(int startIndex, int endIndex, size_t rowBytes,
+                  const std::function<bool(int index, const void* pixels)>& callback,
+                  int maxWorkers = 0, ColorType colorType = ColorType::RGBA_8888,
+                  AlphaType alphaType = AlphaType::Premultiplied);
+
  private:
   std::mutex locker = {};
   int _width = 0;
@@ -1639,6 +1819,7 @@ class PAG_API PAGDecoder {
   std::shared_ptr<PAGComposition> container = nullptr;
   std::shared_ptr<SequenceFile> sequenceFile = nullptr;
   std::shared_ptr<CompositionReader> reader = nullptr;
+  std::vector<std::shared_ptr<CompositionReader>> workerReaders = {};
   std::vector<TimeRange> staticTimeRanges = {};
   std::function<std::string(PAGDecoder*, std::shared_ptr<PAGComposition>)> cacheKeyGeneratorFun =
       nullptr;
@@ -1655,6 +1836,12 @@ class PAG_API PAGDecoder {
   bool readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitmap);
   bool renderFrame(std::shared_ptr<PAGComposition> composition, int index,
                    std::shared_ptr<BitmapBuffer> bitmap);
+  bool readFramesInParallel(const std::vector<TimeRange>& frameRanges,
+                            const tgfx::ImageInfo& info,
+                            const std::function<bool(int, const void*)>& callback);
+  bool readFramesSerially(const std::vector<TimeRange>& frameRanges, const tgfx::ImageInfo& info,
+                          const std::function<bool(int, const void*)>& callback);
+  void checkWorkerReaders(std::shared_ptr<PAGComposition> composition, int numWorkers);
   bool checkSequenceFile(std::shared_ptr<PAGComposition> composition, const tgfx::ImageInfo& info);
   void checkCompositionChange(std::shared_ptr<PAGComposition> composition);
   std::string generateCacheKey(std::shared_ptr<PAGComposition> composition);
@@ -1664,6 +1851,80 @@ class PAG_API PAGDecoder {
   friend class DiskSequenceReader;
 };
 
+/**
+ * Describes the text and image replacements applied to one instance of a template file. The keys
+ * are the editable indices of the text and image layers.
+ */
+class PAG_API PAGReplacementSet {
+ public:
+  std::unordered_map<int, std::shared_ptr<TextDocument>> texts = {};
+  std::unordered_map<int, std::shared_ptr<PAGImage>> images = {};
+};
+
+/**
+ * PAGBatchRenderer renders many instances of one template file, each with its own set of text and
+ * image replacements. All instances share the decoded File and one PAGPlayer, so the caches of the
+ * layers that are not touched by any replacement are only built once for the whole batch.
+ */
+class PAG_API PAGBatchRenderer {
+ public:
+  /**
+   * Creates a PAGBatchRenderer that renders instances of the specified file onto the specified
+   * surface. Returns nullptr if the file or the surface is nullptr.
+   */
+  static std::shared_ptr<PAGBatchRenderer> Make(std::shared_ptr<File> file,
+                                                std::shared_ptr<PAGSurface> surface);
+
+  ~PAGBatchRenderer();
+
+  /**
+   * Returns the PAGSurface object for the PAGBatchRenderer to render onto.
+   */
+  std::shared_ptr<PAGSurface> getSurface();
+
+  /**
+   * Returns the number of frames rendered for each instance.
+   */
+  int numFrames();
+
+  /**
+   * Renders all frames of the instances described by the replacement sets in order. The callback
+   * is called with the index of the replacement set and the frame index after each frame is
+   * flushed to the surface, where the caller can read the pixels back. Return false from the
+   * callback to stop rendering. Replacements are compared by pointer with those of the previous
+   * instance, so pass a new TextDocument or PAGImage instead of modifying a previous one. Returns
+   * false if the rendering was stopped by the callback.
+   */
+  bool render(const std::vector<PAGReplacementSet>& replacementSets,
+              const std::function<bool(size_t setIndex, int frameIndex)>& callback);
+
+ private:
+  std::mutex locker = {};
+  std::shared_ptr<PAGFile> pagFile = nullptr;
+  PAGPlayer* pagPlayer = nullptr;
+  int _numFrames = 0;
+  PAGReplacementSet currentSet = {};
+
+  PAGBatchRenderer(std::shared_ptr<PAGFile> pagFile, std::shared_ptr<PAGSurface> surface);
+
+  void applyReplacementSet(const PAGReplacementSet& replacementSet);
+};
+
+/**
+ * Defines the compression methods for the image frames stored in the disk cache.
+ */
+enum class DiskCacheCompression {
+  /**
+   * LZ4 compression, which is the fastest to encode and decode.
+   */
+  LZ4,
+  /**
+   * Zstandard compression, which produces smaller files than LZ4 at a higher encoding cost. It
+   * falls back to LZ4 if libpag is built without zstd support.
+   */
+  ZSTD,
+};
+
 /**
  * Defines methods to manage the disk cache capabilities.
  */
@@ -1681,6 +1942,33 @@ class PAG_API PAGDiskCache {
    */
   static void SetMaxDiskSize(size_t size);
 
+  /**
+   * Returns the compression method for the frames of the disk cache. The default value is
+   * DiskCacheCompression::LZ4.
+   */
+  static DiskCacheCompression Compression();
+
+  /**
+   * Sets the compression method for the frames of the disk cache. It only affects the cache files
+   * created afterwards, the existing files are still readable with their own compression methods.
+   */
+  static void SetCompression(DiskCacheCompression compression);
+
+  /**
+   * Returns the keyframe interval of the disk cache. The default value is 0, which means every
+   * frame is compressed independently.
+   */
+  static int KeyframeInterval();
+
+  /**
+   * Sets the keyframe interval of the disk cache. If the interval is greater than 1, only one frame
+   * out of every interval is compressed independently, the others are stored as the XOR difference
+   * against the previous keyframe, which usually makes consecutive animation frames much smaller.
+   * Reading a difference frame requires decoding its keyframe as well. It only affects the cache
+   * files created afterwards.
+   */
+  static void SetKeyframeInterval(int interval);
+
   /**
    * Removes all cached files from the disk. All the opened files will be also removed after they
    * are closed.
@@ -1688,6 +1976,125 @@ class PAG_API PAGDiskCache {
   static void RemoveAll();
 };
 
+/**
+ * Defines methods to manage the memory used by the per-frame caches of layers, such as transforms,
+ * masks and contents. The caches keep every rendered frame by default until the associated PAGFile
+ * is released, setting a budget makes them evict the least recently used frames instead, which
+ * keeps the memory constant when rendering long animations sequentially.
+ */
+class PAG_API PAGFrameCache {
+ public:
+  /**
+   * Returns the memory limit of the frame cache of a single layer in bytes. The default value is 0,
+   * which means unlimited.
+   */
+  static size_t MaxCacheMemory();
+
+  /**
+   * Sets the memory limit of the frame cache of a single layer in bytes. Set it to 0 to disable the
+   * limit.
+   */
+  static void SetMaxCacheMemory(size_t bytes);
+
+  /**
+   * Returns the memory limit of all frame caches in bytes. The default value is 0, which means
+   * unlimited.
+   */
+  static size_t MaxTotalMemory();
+
+  /**
+   * Sets the memory limit of all frame caches in bytes. Set it to 0 to disable the limit. The limit
+   * is best-effort: a frame cache only evicts its own frames when a new frame is added to it, and
+   * it always keeps its two most recent frames, so the total memory can still exceed the limit
+   * when many caches are each holding only a few frames.
+   */
+  static void SetMaxTotalMemory(size_t bytes);
+
+  /**
+   * Returns the estimated memory used by all frame caches in bytes.
+   */
+  static size_t TotalMemory();
+};
+
+/**
+ * Defines methods to control how many frames of video and bitmap sequences are decoded ahead of
+ * rendering in background threads.
+ */
+class PAG_API PAGSequencePrefetch {
+ public:
+  /**
+   * Returns the maximum number of frames decoded ahead for each playing sequence. The default value
+   * is 1.
+   */
+  static int MaxFrameCount();
+
+  /**
+   * Sets the maximum number of frames decoded ahead for each playing sequence. Decoding more frames
+   * ahead smooths out the frames that take longer than one frame interval to decode, at the cost
+   * of memory. The sequences decoded by hardware video decoders always keep only one frame ahead.
+   */
+  static void SetMaxFrameCount(int count);
+
+  /**
+   * Returns the memory limit of the frames decoded ahead for each playing sequence in bytes. The
+   * default value is 32 MB.
+   */
+  static size_t MaxMemory();
+
+  /**
+   * Sets the memory limit of the frames decoded ahead for each playing sequence in bytes. At least
+   * one frame is always decoded ahead regardless of the limit. Set it to 0 to disable the limit.
+   */
+  static void SetMaxMemory(size_t bytes);
+};
+
+/**
+ * Defines methods to manage the graphics memory used by the internal caches of PAGPlayers, such as
+ * snapshots and text atlases.
+ */
+class PAG_API PAGGraphicsMemory {
+ public:
+  /**
+   * Returns the default soft limit of the graphics memory for new PAGPlayers in bytes. The default
+   * value is 20 MB.
+   */
+  static size_t DefaultSoftLimit();
+
+  /**
+   * Sets the default soft limit of the graphics memory for new PAGPlayers in bytes.
+   */
+  static void SetDefaultSoftLimit(size_t bytes);
+
+  /**
+   * Returns the default hard limit of the graphics memory for new PAGPlayers in bytes. The default
+   * value is 300 MB.
+   */
+  static size_t DefaultHardLimit();
+
+  /**
+   * Sets the default hard limit of the graphics memory for new PAGPlayers in bytes.
+   */
+  static void SetDefaultHardLimit(size_t bytes);
+
+  /**
+   * Returns the limit of the graphics memory shared by all PAGPlayers in the process in bytes. The
+   * default value is 0, which means unlimited.
+   */
+  static size_t MaxTotalMemory();
+
+  /**
+   * Sets the limit of the graphics memory shared by all PAGPlayers in the process in bytes. Every
+   * player stops creating new caches and purges its own caches at the end of a frame while the
+   * total memory usage is over the limit.
+   */
+  static void SetMaxTotalMemory(size_t bytes);
+
+  /**
+   * Returns the graphics memory used by the caches of all PAGPlayers in the process in bytes.
+   */
+  static size_t TotalMemory();
+};
+
 /**
  * Defines methods to control video decoding capabilities of PAG.
  */
@@ -1703,6 +2110,35 @@ class PAG_API PAGVideoDecoder {
    * decoding video sequences from a pag file, if hardware decoders are not available.
    */
   static void RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* decoderFactory);
+
+  /**
+   * Set the number of CPU cores that each built-in libavc decoder can use to decode a video
+   * sequence. It has no effect on the registered software decoder factory. The default value is 1.
+   */
+  static void SetSoftwareDecoderCoreCount(int count);
+
+  /**
+   * Set the maximum number of GOPs (the frames from one keyframe to the next) of a video sequence
+   * that PAG can decode ahead in parallel. Each of them is decoded by a separate video decoder in a
+   * background thread, and the decoded frames are kept in memory until the playback moves past
+   * them. The GOPs decoded ahead of the current one are also limited to 90 frames in total. The
+   * parallel decoding is disabled if the count is less than 2, which is the default.
+   */
+  static void SetMaxParallelGOPCount(int count);
+
+  /**
+   * Set the maximum number of idle software video decoders that PAG keeps in a process-wide pool.
+   * The decoders released by players are kept in the pool, and the following players decoding
+   * videos of the same format reuse them instead of creating and configuring new ones. The default
+   * value is 0, which disables the pool.
+   */
+  static void SetMaxPooledDecoderCount(int count);
+
+  /**
+   * Set the time in microseconds that an idle video decoder can stay in the pool before it is
+   * destroyed. The limit is checked whenever the pool is accessed. The default value is 10 seconds.
+   */
+  static void SetPooledDecoderIdleTime(int64_t time);
 };
 
 class PAG_API PAG {
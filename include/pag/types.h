@@ -1589,6 +1589,15 @@ class PAG_API ByteData {
    * Creates a ByteData object from the specified file path.
    */
   static std::unique_ptr<ByteData> FromPath(const std::string& filePath);
+  /**
+   * Creates a ByteData object by mapping the specified file into memory instead of reading it onto
+   * the heap. The mapping is private, any modification to the data is never written back to the
+   * file. Falls back to FromPath() if the file is not a regular file or can not be mapped.
+   * Note: The file must not be truncated or rewritten while the ByteData is alive. Reading the
+   * pages that were cut off from the mapping raises SIGBUS on most platforms. Use FromPath() for
+   * files that may be modified by other processes.
+   */
+  static std::unique_ptr<ByteData> FromPathMapped(const std::string& filePath);
   /**
    * Creates a ByteData object and copy the specified data into it.
    */
@@ -18,6 +18,12 @@
 
 #include "pag/file.h"
 #include "tgfx/utils/Stream.h"
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace pag {
 std::unique_ptr<ByteData> ByteData::FromPath(const std::string& filePath) {
@@ -33,6 +39,34 @@ std::unique_ptr<ByteData> ByteData::FromPath(const std::string& filePath) {
   return data;
 }
 
+std::unique_ptr<ByteData> ByteData::FromPathMapped(const std::string& filePath) {
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+  auto fd = open(filePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return FromPath(filePath);
+  }
+  struct stat fileStat = {};
+  // Only regular files are mapped, the others, such as pipes and devices, may change their contents
+  // or size at any time.
+  if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0) {
+    close(fd);
+    return FromPath(filePath);
+  }
+  auto length = static_cast<size_t>(fileStat.st_size);
+  // A private mapping never writes back to the file, and pages are only copied if they are
+  // modified.
+  auto address = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    return FromPath(filePath);
+  }
+  return MakeAdopted(static_cast<uint8_t*>(address), length,
+                     [length](uint8_t* data) { munmap(data, length); });
+#else
+  return FromPath(filePath);
+#endif
+}
+
 std::unique_ptr<ByteData> ByteData::MakeCopy(const void* bytes, size_t length) {
   if (length == 0) {
     return Make(0);
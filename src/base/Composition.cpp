@@ -26,7 +26,7 @@ Composition::Composition() : uniqueID(UniqueID::Next()) {
 }
 
 Composition::~Composition() {
-  delete cache;
+  delete cache.load();
   delete audioBytes;
   for (auto& marker : audioMarkers) {
     delete marker;
@@ -54,12 +54,29 @@ static std::shared_ptr<File> FindFileByPath(const std::string& filePath) {
   return nullptr;
 }
 
-std::shared_ptr<File> File::Load(const std::string& filePath, const std::string& password) {
-  auto byteData = ByteData::FromPath(filePath);
+static void AddFileToCache(const std::string& filePath, std::shared_ptr<File> file) {
+  if (file == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(globalLocker);
+  std::weak_ptr<File> weak = file;
+  weakFileMap.insert(std::make_pair(filePath, std::move(weak)));
+}
+
+std::shared_ptr<File> File::Load(const std::string& filePath, const std::string&) {
+  auto file = FindFileByPath(filePath);
+  if (file != nullptr) {
+    return file;
+  }
+  auto byteData = ByteData::FromPathMapped(filePath);
   if (byteData == nullptr) {
     return nullptr;
   }
-  return pag::File::Load(byteData->data(), byteData->length(), filePath, password);
+  // The decoded file shares the byte data instead of copying the video frames out of it, the byte
+  // data is released once nothing refers to it anymore.
+  file = Codec::Decode(std::shared_ptr<ByteData>(std::move(byteData)), filePath);
+  AddFileToCache(filePath, file);
+  return file;
 }
 
 std::shared_ptr<File> File::Load(const void* bytes, size_t length, const std::string& filePath,
@@ -69,11 +86,7 @@ std::shared_ptr<File> File::Load(const void* bytes, size_t length, const std::st
     return file;
   }
   file = Codec::Decode(bytes, static_cast<uint32_t>(length), filePath);
-  if (file != nullptr) {
-    std::lock_guard<std::mutex> autoLock(globalLocker);
-    std::weak_ptr<File> weak = file;
-    weakFileMap.insert(std::make_pair(filePath, std::move(weak)));
-  }
+  AddFileToCache(filePath, file);
   return file;
 }
 
@@ -25,7 +25,7 @@ ImageBytes::ImageBytes() : uniqueID(UniqueID::Next()) {
 }
 
 ImageBytes::~ImageBytes() {
-  delete cache;
+  delete cache.load();
   delete fileBytes;
 }
 
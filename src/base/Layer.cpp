@@ -26,7 +26,7 @@ Layer::Layer() : uniqueID(UniqueID::Next()) {
 }
 
 Layer::~Layer() {
-  delete cache;
+  delete cache.load();
   delete transform;
   delete transform3D;
   delete timeRemap;
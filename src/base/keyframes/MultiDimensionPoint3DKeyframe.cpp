@@ -30,6 +30,9 @@ void MultiDimensionPoint3DKeyframe::initialize() {
     xInterpolator = new BezierEasing(this->bezierOut[0], this->bezierIn[0]);
     yInterpolator = new BezierEasing(this->bezierOut[1], this->bezierIn[1]);
     zInterpolator = new BezierEasing(this->bezierOut[2], this->bezierIn[2]);
+    xEasingTable.build(xInterpolator, startTime, endTime);
+    yEasingTable.build(yInterpolator, startTime, endTime);
+    zEasingTable.build(zInterpolator, startTime, endTime);
   } else {
     xInterpolator = new Interpolator();
     yInterpolator = new Interpolator();
@@ -38,10 +41,9 @@ void MultiDimensionPoint3DKeyframe::initialize() {
 }
 
 Point3D MultiDimensionPoint3DKeyframe::getValueAt(Frame time) {
-  auto progress = static_cast<float>(time - this->startTime) / (this->endTime - this->startTime);
-  auto xProgress = xInterpolator->getInterpolation(progress);
-  auto yProgress = yInterpolator->getInterpolation(progress);
-  auto zProgress = zInterpolator->getInterpolation(progress);
+  auto xProgress = xEasingTable.getInterpolation(xInterpolator, startTime, endTime, time);
+  auto yProgress = yEasingTable.getInterpolation(yInterpolator, startTime, endTime, time);
+  auto zProgress = zEasingTable.getInterpolation(zInterpolator, startTime, endTime, time);
   auto x = Interpolate(this->startValue.x, this->endValue.x, xProgress);
   auto y = Interpolate(this->startValue.y, this->endValue.y, yProgress);
   auto z = Interpolate(this->startValue.z, this->endValue.z, zProgress);
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/utils/BezierEasing.h"
+#include "base/utils/EasingTable.h"
 #include "pag/file.h"
 
 namespace pag {
@@ -34,5 +35,8 @@ class MultiDimensionPoint3DKeyframe : public Keyframe<Point3D> {
   Interpolator* xInterpolator = nullptr;
   Interpolator* yInterpolator = nullptr;
   Interpolator* zInterpolator = nullptr;
+  EasingTable xEasingTable = {};
+  EasingTable yEasingTable = {};
+  EasingTable zEasingTable = {};
 };
 }  // namespace pag
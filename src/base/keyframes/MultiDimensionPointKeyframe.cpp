@@ -28,6 +28,8 @@ void MultiDimensionPointKeyframe::initialize() {
   if (interpolationType == KeyframeInterpolationType::Bezier) {
     xInterpolator = new BezierEasing(this->bezierOut[0], this->bezierIn[0]);
     yInterpolator = new BezierEasing(this->bezierOut[1], this->bezierIn[1]);
+    xEasingTable.build(xInterpolator, startTime, endTime);
+    yEasingTable.build(yInterpolator, startTime, endTime);
   } else {
     xInterpolator = new Interpolator();
     yInterpolator = new Interpolator();
@@ -35,9 +37,8 @@ void MultiDimensionPointKeyframe::initialize() {
 }
 
 Point MultiDimensionPointKeyframe::getValueAt(Frame time) {
-  auto progress = static_cast<float>(time - this->startTime) / (this->endTime - this->startTime);
-  auto xProgress = xInterpolator->getInterpolation(progress);
-  auto yProgress = yInterpolator->getInterpolation(progress);
+  auto xProgress = xEasingTable.getInterpolation(xInterpolator, startTime, endTime, time);
+  auto yProgress = yEasingTable.getInterpolation(yInterpolator, startTime, endTime, time);
   auto x = Interpolate(this->startValue.x, this->endValue.x, xProgress);
   auto y = Interpolate(this->startValue.y, this->endValue.y, yProgress);
   return {x, y};
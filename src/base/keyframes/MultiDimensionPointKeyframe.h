@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/utils/BezierEasing.h"
+#include "base/utils/EasingTable.h"
 #include "pag/file.h"
 
 namespace pag {
@@ -33,5 +34,7 @@ class MultiDimensionPointKeyframe : public Keyframe<Point> {
  private:
   Interpolator* xInterpolator = nullptr;
   Interpolator* yInterpolator = nullptr;
+  EasingTable xEasingTable = {};
+  EasingTable yEasingTable = {};
 };
 }  // namespace pag
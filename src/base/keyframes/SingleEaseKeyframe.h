@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/utils/BezierEasing.h"
+#include "base/utils/EasingTable.h"
 #include "pag/file.h"
 
 namespace pag {
@@ -32,14 +33,14 @@ class SingleEaseKeyframe : public Keyframe<T> {
   void initialize() override {
     if (this->interpolationType == KeyframeInterpolationType::Bezier) {
       interpolator = new BezierEasing(this->bezierOut[0], this->bezierIn[0]);
+      easingTable.build(interpolator, this->startTime, this->endTime);
     } else {
       interpolator = new Interpolator();
     }
   }
 
   float getProgress(Frame time) {
-    auto progress = static_cast<float>(time - this->startTime) / (this->endTime - this->startTime);
-    return interpolator->getInterpolation(progress);
+    return easingTable.getInterpolation(interpolator, this->startTime, this->endTime, time);
   }
 
   T getValueAt(Frame time) override {
@@ -49,5 +50,6 @@ class SingleEaseKeyframe : public Keyframe<T> {
 
  private:
   Interpolator* interpolator = nullptr;
+  EasingTable easingTable = {};
 };
 }  // namespace pag
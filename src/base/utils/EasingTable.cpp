@@ -0,0 +1,48 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "EasingTable.h"
+
+namespace pag {
+static float GetLinearProgress(Frame startTime, Frame endTime, Frame time) {
+  return static_cast<float>(time - startTime) / (endTime - startTime);
+}
+
+void EasingTable::build(Interpolator* interpolator, Frame startTime, Frame endTime) {
+  tableStartTime = startTime;
+  tableEndTime = endTime;
+  values.clear();
+  auto frameCount = endTime - startTime;
+  if (frameCount <= 0 || frameCount > MaxFrameCount) {
+    return;
+  }
+  values.reserve(static_cast<size_t>(frameCount));
+  for (auto time = startTime; time < endTime; time++) {
+    values.push_back(interpolator->getInterpolation(GetLinearProgress(startTime, endTime, time)));
+  }
+}
+
+float EasingTable::getInterpolation(Interpolator* interpolator, Frame startTime, Frame endTime,
+                                    Frame time) const {
+  if (!values.empty() && startTime == tableStartTime && endTime == tableEndTime &&
+      time >= startTime && time < endTime) {
+    return values[static_cast<size_t>(time - startTime)];
+  }
+  return interpolator->getInterpolation(GetLinearProgress(startTime, endTime, time));
+}
+}  // namespace pag
@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "Interpolator.h"
+
+namespace pag {
+/**
+ * EasingTable caches the eased progress of every whole frame in a keyframe's time range. Keyframes
+ * are always evaluated at whole frames, so the cached values are identical to what the
+ * interpolator returns, but looking them up skips the bezier segment search on every call. The
+ * table is filled once during keyframe initialization and is read-only afterwards, which makes it
+ * safe to share across threads.
+ */
+class EasingTable {
+ public:
+  /**
+   * The maximum number of frames to cache for one keyframe. Longer keyframes fall back to the
+   * interpolator.
+   */
+  static constexpr Frame MaxFrameCount = 256;
+
+  /**
+   * Samples the interpolator at every whole frame in [startTime, endTime).
+   */
+  void build(Interpolator* interpolator, Frame startTime, Frame endTime);
+
+  /**
+   * Returns the eased progress of the specified frame in [startTime, endTime). Falls back to the
+   * interpolator if the frame is not cached or the time range has changed since the table was
+   * built.
+   */
+  float getInterpolation(Interpolator* interpolator, Frame startTime, Frame endTime,
+                         Frame time) const;
+
+ private:
+  Frame tableStartTime = 0;
+  Frame tableEndTime = 0;
+  std::vector<float> values = {};
+};
+}  // namespace pag
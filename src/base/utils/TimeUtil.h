@@ -30,6 +30,20 @@ inline int64_t FrameToTime(Frame frame, double frameRate) {
   return static_cast<Frame>(ceil(frame * 1000000.0 / frameRate));
 }
 
+/**
+ * Returns the earliest time that TimeToFrame() maps to the specified frame or a later one.
+ */
+inline int64_t FrameToEarliestTime(Frame frame, double frameRate) {
+  auto time = FrameToTime(frame, frameRate);
+  while (TimeToFrame(time, frameRate) < frame) {
+    time++;
+  }
+  while (TimeToFrame(time - 1, frameRate) >= frame) {
+    time--;
+  }
+  return time;
+}
+
 inline double ClampProgress(double progress) {
   auto percent = fmod(progress, 1.0);
   if (percent <= 0 && progress != 0) {
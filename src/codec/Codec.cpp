@@ -16,6 +16,7 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include "CompressionAlgorithm.h"
@@ -44,10 +45,20 @@ static bool HasTrackMatte(Enum type) {
   }
 }
 
+static std::atomic_bool parallelDecodingEnabled = {false};
+
 uint16_t Codec::MaxSupportedTagLevel() {
   return static_cast<uint16_t>(TagCode::Count) - 1;
 }
 
+bool Codec::ParallelDecodingEnabled() {
+  return parallelDecodingEnabled;
+}
+
+void Codec::SetParallelDecodingEnabled(bool value) {
+  parallelDecodingEnabled = value;
+}
+
 template <typename T>
 ID GetReferenceID(T* item) {
   return item ? item->id : 0;
@@ -210,27 +221,46 @@ DecodeStream ReadBodyBytes(DecodeStream* stream) {
 std::shared_ptr<File> Codec::Decode(const void* bytes, uint32_t byteLength,
                                     const std::string& filePath) {
   CodecContext context = {};
-  DecodeStream stream(&context, reinterpret_cast<const uint8_t*>(bytes), byteLength);
+  return Decode(&context, bytes, byteLength, filePath);
+}
+
+std::shared_ptr<File> Codec::Decode(std::shared_ptr<ByteData> fileBytes,
+                                    const std::string& filePath) {
+  if (fileBytes == nullptr) {
+    return nullptr;
+  }
+  CodecContext context = {};
+  context.sourceBytes = fileBytes;
+  return Decode(&context, fileBytes->data(), static_cast<uint32_t>(fileBytes->length()), filePath);
+}
+
+std::shared_ptr<File> Codec::Decode(CodecContext* context, const void* bytes, uint32_t byteLength,
+                                    const std::string& filePath) {
+  DecodeStream stream(context, reinterpret_cast<const uint8_t*>(bytes), byteLength);
   auto bodyBytes = ReadBodyBytes(&stream);
-  if (context.hasException()) {
+  if (context->hasException()) {
     return nullptr;
   }
-  ReadTags(&bodyBytes, &context, ReadTagsOfFile);
-  if (context.hasException()) {
+  if (parallelDecodingEnabled) {
+    ReadTagsOfFileInParallel(&bodyBytes, context);
+  } else {
+    ReadTags(&bodyBytes, context, ReadTagsOfFile);
+  }
+  if (context->hasException()) {
     return nullptr;
   }
-  InstallReferences(context.compositions);
-  if (context.hasException()) {
+  InstallReferences(context->compositions);
+  if (context->hasException()) {
     return nullptr;
   }
 
   // Verify 提前到使用之前，避免未经Verify导致使用时crash
-  auto file = VerifyAndMake(context.releaseCompositions(), context.releaseImages());
+  auto file = VerifyAndMake(context->releaseCompositions(), context->releaseImages());
   if (file == nullptr) {
     return nullptr;
   }
 
-  UpdateFileAttributes(file, &context, filePath);
+  UpdateFileAttributes(file, context, filePath);
   return file;
 }
 
@@ -36,7 +36,6 @@ CodecContext::~CodecContext() {
     delete image;
   }
   images.clear();
-  errorMessages.clear();
   delete scaledTimeRange;
 }
 
@@ -46,6 +45,9 @@ FontData CodecContext::getFontData(int id) {
     auto font = result->second;
     return {font->fontFamily, font->fontStyle};
   }
+  if (parent != nullptr) {
+    return parent->getFontData(id);
+  }
   return FontData("", "");
 }
 
@@ -55,11 +57,25 @@ ImageBytes* CodecContext::getImageBytes(pag::ID imageID) {
       return image;
     }
   }
+  if (parent != nullptr) {
+    for (auto image : parent->images) {
+      if (image->id == imageID) {
+        return image;
+      }
+    }
+  }
   for (auto image : images) {
     if (image->fileBytes == nullptr) {
       return image;
     }
   }
+  if (parent != nullptr) {
+    for (auto image : parent->images) {
+      if (image->fileBytes == nullptr) {
+        return image;
+      }
+    }
+  }
   auto image = new ImageBytes();
   images.push_back(image);
   return image;
@@ -38,7 +38,6 @@ class CodecContext : public StreamContext {
   std::vector<Composition*> releaseCompositions();
   std::vector<ImageBytes*> releaseImages();
 
-  std::vector<std::string> errorMessages;
   std::unordered_map<std::string, FontDescriptor*> fontNameMap;
   std::unordered_map<int, FontDescriptor*> fontIDMap;
   std::vector<Composition*> compositions;
@@ -51,5 +50,12 @@ class CodecContext : public StreamContext {
   std::vector<int>* editableTexts = nullptr;
   std::vector<Enum>* imageScaleModes = nullptr;
   uint16_t tagLevel = 0;
+  // The bytes being decoded, if they are kept alive after decoding. Video frames are read as views
+  // into them instead of copies when it is set.
+  std::shared_ptr<ByteData> sourceBytes = nullptr;
+  // The context this one is forked from when a single tag is decoded on a worker thread. Fonts and
+  // images that can not be found locally are looked up in it, which must not be modified until the
+  // forked context is done.
+  CodecContext* parent = nullptr;
 };
 }  // namespace pag
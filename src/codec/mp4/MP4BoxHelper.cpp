@@ -70,10 +70,12 @@ static std::shared_ptr<MP4Track> MakeMP4Track(const VideoSequence* videoSequence
     headerLen += static_cast<int>(header->length());
   }
 
+  // Each sample is stored with a 4-byte length prefix in the mdat box.
+  auto prefixSize = videoSequence->hasFrameStartCodes ? 0 : 4;
   auto sampleDelta = mp4Track->duration / static_cast<int32_t>(videoSequence->frames.size());
   int count = 0;
   for (const auto* frame : videoSequence->frames) {
-    int sampleSize = static_cast<int>(frame->fileBytes->length());
+    int sampleSize = static_cast<int>(frame->fileBytes->length()) + prefixSize;
     if (count == 0) {
       sampleSize += headerLen;
     }
@@ -110,10 +112,11 @@ static void WriteMdatBox(const VideoSequence* videoSequence, EncodeStream* paylo
     payload->writeInt32(payLoadSize);
     payload->writeBytes(header->data(), payLoadSize, splitSize);
   }
+  int32_t frameSplitSize = videoSequence->hasFrameStartCodes ? splitSize : 0;
   for (const auto* frame : videoSequence->frames) {
-    int32_t payLoadSize = static_cast<int32_t>(frame->fileBytes->length()) - splitSize;
+    int32_t payLoadSize = static_cast<int32_t>(frame->fileBytes->length()) - frameSplitSize;
     payload->writeInt32(payLoadSize);
-    payload->writeBytes(frame->fileBytes->data(), payLoadSize, splitSize);
+    payload->writeBytes(frame->fileBytes->data(), payLoadSize, frameSplitSize);
   }
 }
 
@@ -124,8 +127,9 @@ static std::unique_ptr<ByteData> ConcatMP4(const VideoSequence* videoSequence) {
     auto needSize = static_cast<int32_t>(header->length());
     mdatSize += needSize;
   }
+  auto prefixSize = videoSequence->hasFrameStartCodes ? 0 : 4;
   for (auto frame : videoSequence->frames) {
-    auto needSize = static_cast<int32_t>(frame->fileBytes->length());
+    auto needSize = static_cast<int32_t>(frame->fileBytes->length()) + prefixSize;
     mdatSize += needSize;
   }
   mdatSize += 8;
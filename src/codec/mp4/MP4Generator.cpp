@@ -51,10 +51,11 @@ int MP4Generator::writeH264Nalus(EncodeStream* stream, bool write) const {
     stream->writeInt32(payloadSize);
     stream->writeBytes(header->data(), payloadSize, 4);
   }
+  auto startCodeSize = param.videoSequence->hasFrameStartCodes ? 4 : 0;
   for (const auto* frame : param.videoSequence->frames) {
-    int32_t payloadSize = static_cast<int32_t>(frame->fileBytes->length()) - 4;
+    int32_t payloadSize = static_cast<int32_t>(frame->fileBytes->length()) - startCodeSize;
     stream->writeInt32(payloadSize);
-    stream->writeBytes(frame->fileBytes->data(), payloadSize, 4);
+    stream->writeBytes(frame->fileBytes->data(), payloadSize, startCodeSize);
   }
   return param.nalusBytesLen;
 }
@@ -17,6 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "FileTags.h"
+#include <atomic>
+#include <thread>
 #include <unordered_set>
 #include "base/utils/EnumClassHash.h"
 #include "codec/tags/BitmapCompositionTag.h"
@@ -29,6 +31,7 @@
 #include "codec/tags/TimeStretchMode.h"
 #include "codec/tags/VectorCompositionTag.h"
 #include "codec/tags/VideoCompositionTag.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
 static void ReadTag_FontTables(DecodeStream* stream, CodecContext*) {
@@ -108,6 +111,120 @@ void ReadTagsOfFile(DecodeStream* stream, TagCode code, CodecContext* context) {
   }
 }
 
+static bool IsImageTag(TagCode code) {
+  return code == TagCode::ImageBytes || code == TagCode::ImageBytesV2 ||
+         code == TagCode::ImageBytesV3;
+}
+
+static bool IsCompositionTag(TagCode code) {
+  return code == TagCode::VectorCompositionBlock || code == TagCode::BitmapCompositionBlock ||
+         code == TagCode::VideoCompositionBlock;
+}
+
+struct ForkedTag {
+  TagCode code;
+  const uint8_t* data;
+  uint32_t length;
+  // The index reserved for the result in CodecContext::images or CodecContext::compositions.
+  size_t slot;
+};
+
+static void RunConcurrently(size_t count, const std::function<void(size_t)>& task) {
+  auto numWorkers = std::min(static_cast<size_t>(std::thread::hardware_concurrency()), count);
+  std::atomic<size_t> nextIndex = {0};
+  auto work = [&]() {
+    auto index = nextIndex.fetch_add(1);
+    while (index < count) {
+      task(index);
+      index = nextIndex.fetch_add(1);
+    }
+  };
+  std::vector<std::shared_ptr<tgfx::Task>> tasks = {};
+  for (size_t i = 1; i < numWorkers; i++) {
+    auto task = tgfx::Task::Run(work);
+    if (task != nullptr) {
+      tasks.push_back(task);
+    }
+  }
+  work();
+  for (auto& task : tasks) {
+    task->wait();
+  }
+}
+
+static void ReadForkedTags(const std::vector<ForkedTag>& tags, CodecContext* context) {
+  std::vector<std::unique_ptr<CodecContext>> forks(tags.size());
+  RunConcurrently(tags.size(), [&](size_t index) {
+    auto& tag = tags[index];
+    auto fork = new CodecContext();
+    fork->sourceBytes = context->sourceBytes;
+    fork->parent = context;
+    forks[index].reset(fork);
+    DecodeStream stream(fork, tag.data, tag.length);
+    ReadTagsOfFile(&stream, tag.code, fork);
+  });
+  for (size_t index = 0; index < tags.size(); index++) {
+    auto& tag = tags[index];
+    auto fork = forks[index].get();
+    context->tagLevel = std::max(context->tagLevel, fork->tagLevel);
+    if (fork->hasException()) {
+      for (auto& message : fork->errorMessages) {
+        context->throwException(message);
+      }
+      continue;
+    }
+    auto compositions = fork->releaseCompositions();
+    auto images = fork->releaseImages();
+    if (IsCompositionTag(tag.code)) {
+      if (!compositions.empty()) {
+        context->compositions[tag.slot] = compositions.front();
+      }
+    } else if (!images.empty()) {
+      context->images[tag.slot] = images.front();
+      images.erase(images.begin());
+    }
+    // Images created by unresolved ImageReferences are appended just like the serial decoding.
+    context->images.insert(context->images.end(), images.begin(), images.end());
+  }
+}
+
+void ReadTagsOfFileInParallel(DecodeStream* stream, CodecContext* context) {
+  std::vector<ForkedTag> imageTags = {};
+  std::vector<ForkedTag> compositionTags = {};
+  auto header = ReadTagHeader(stream);
+  if (context->hasException()) {
+    return;
+  }
+  while (header.code != TagCode::End) {
+    auto tagBytes = stream->readBytes(header.length);
+    if (IsImageTag(header.code)) {
+      imageTags.push_back(
+          {header.code, tagBytes.data(), tagBytes.length(), context->images.size()});
+      context->images.push_back(nullptr);
+    } else if (IsCompositionTag(header.code)) {
+      compositionTags.push_back(
+          {header.code, tagBytes.data(), tagBytes.length(), context->compositions.size()});
+      context->compositions.push_back(nullptr);
+    } else {
+      ReadTagsOfFile(&tagBytes, header.code, context);
+    }
+    if (context->hasException()) {
+      return;
+    }
+    header = ReadTagHeader(stream);
+    if (context->hasException()) {
+      return;
+    }
+  }
+  // Compositions look up their images by ID, so all images must be in place before compositions
+  // are decoded.
+  ReadForkedTags(imageTags, context);
+  if (context->hasException()) {
+    return;
+  }
+  ReadForkedTags(compositionTags, context);
+}
+
 void GetFontFromTextDocument(std::vector<FontData>& fontList,
                              std::unordered_set<std::string>& fontSet,
                              const TextDocumentHandle& textDocument) {
@@ -23,6 +23,13 @@
 namespace pag {
 void ReadTagsOfFile(DecodeStream* stream, TagCode code, CodecContext* context);
 
+/**
+ * Reads all tags of a file like ReadTags(stream, context, ReadTagsOfFile) does, but decodes the
+ * image and composition tags concurrently. The results are stored in the same order as they appear
+ * in the file. References between them are left for Codec::InstallReferences() to resolve.
+ */
+void ReadTagsOfFileInParallel(DecodeStream* stream, CodecContext* context);
+
 void WriteTagsOfFile(EncodeStream* stream, const File* file, PerformanceData* performanceData);
 
 std::vector<FontData> GetFontList(std::vector<Composition*> compositions);
@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "VideoSequence.h"
+#include "codec/CodecContext.h"
 #include "codec/utils/NALUReader.h"
 
 namespace pag {
@@ -42,10 +43,19 @@ VideoSequence* ReadVideoSequence(DecodeStream* stream, bool hasAlpha) {
     sequence->frames.push_back(videoFrame);
     videoFrame->isKeyframe = stream->readBitBoolean();
   }
+  // The video frames usually take up most of a pag file. Keep them as views into the source bytes
+  // if they stay alive after decoding, the start codes are written while submitting the frames to
+  // the video decoder.
+  auto sourceBytes = static_cast<CodecContext*>(stream->context)->sourceBytes;
+  sequence->hasFrameStartCodes = sourceBytes == nullptr;
   for (uint32_t i = 0; i < count; i++) {
     auto videoFrame = sequence->frames[i];
     videoFrame->frame = ReadTime(stream);
-    videoFrame->fileBytes = ReadByteDataWithStartCode(stream).release();
+    if (sourceBytes != nullptr) {
+      videoFrame->fileBytes = ReadByteDataView(stream, sourceBytes).release();
+    } else {
+      videoFrame->fileBytes = ReadByteDataWithStartCode(stream).release();
+    }
   }
 
   if (stream->bytesAvailable() > 0) {
@@ -61,16 +71,18 @@ VideoSequence* ReadVideoSequence(DecodeStream* stream, bool hasAlpha) {
   return sequence;
 }
 
-static void WriteByteDataWithoutStartCode(EncodeStream* stream, ByteData* byteData) {
+static void WriteByteDataWithoutStartCode(EncodeStream* stream, ByteData* byteData,
+                                          bool hasStartCode = true) {
+  auto startCodeSize = hasStartCode ? 4u : 0u;
   auto length = static_cast<uint32_t>(byteData->length());
-  if (length < 4) {
+  if (length < startCodeSize) {
     length = 0;
   } else {
-    length -= 4;
+    length -= startCodeSize;
   }
   stream->writeEncodedUint32(length);
   // Skip Annex B Prefix
-  stream->writeBytes(byteData->data() + 4, length);
+  stream->writeBytes(byteData->data() + startCodeSize, length);
 }
 
 TagCode WriteVideoSequence(EncodeStream* stream, std::pair<VideoSequence*, bool>* parameter) {
@@ -96,7 +108,7 @@ TagCode WriteVideoSequence(EncodeStream* stream, std::pair<VideoSequence*, bool>
   for (uint32_t i = 0; i < count; i++) {
     auto videoFrame = sequence->frames[i];
     WriteTime(stream, videoFrame->frame);
-    WriteByteDataWithoutStartCode(stream, videoFrame->fileBytes);
+    WriteByteDataWithoutStartCode(stream, videoFrame->fileBytes, sequence->hasFrameStartCodes);
   }
 
   stream->writeEncodedUint32(static_cast<uint32_t>(sequence->staticTimeRanges.size()));
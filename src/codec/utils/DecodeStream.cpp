@@ -220,72 +220,133 @@ uint64_t DecodeStream::readEncodedUint64() {
   return value;
 }
 
-int32_t DecodeStream::readBits(uint8_t numBits) {
-  auto value = readUBits(numBits);
+static inline uint64_t ReadUint64LE(const uint8_t* bytes) {
+  uint64_t value = 0;
+  memcpy(&value, bytes, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+/**
+ * Returns numBits (at most 32) bits starting at bitPosition. Reads a whole 64-bit word at once
+ * instead of one byte at a time, the caller must make sure the bits are within the data.
+ */
+static inline uint32_t PeekBits(const uint8_t* bytes, size_t length, size_t bitPosition,
+                                uint8_t numBits) {
+  auto bytePosition = bitPosition >> 3;
+  uint64_t word = 0;
+  if (bytePosition + sizeof(uint64_t) <= length) {
+    word = ReadUint64LE(bytes + bytePosition);
+  } else {
+    for (size_t i = bytePosition; i < length; i++) {
+      word |= static_cast<uint64_t>(bytes[i]) << ((i - bytePosition) * 8);
+    }
+  }
+  word >>= (bitPosition & 7);
+  return static_cast<uint32_t>(word & ((static_cast<uint64_t>(1) << numBits) - 1));
+}
+
+static inline int32_t SignExtend(uint32_t value, uint8_t numBits) {
+  if (numBits == 0) {
+    return 0;
+  }
   value <<= (32 - numBits);
   auto data = static_cast<int32_t>(value);
   return data >> (32 - numBits);
 }
 
+int32_t DecodeStream::readBits(uint8_t numBits) {
+  return SignExtend(readUBits(numBits), numBits);
+}
+
 uint32_t DecodeStream::readUBits(uint8_t numBits) {
-  static const uint8_t bitMasks[9] = {0, 1, 3, 7, 15, 31, 63, 127, 255};
   uint32_t value = 0;
-  auto length = dataView.size();
-  auto bytes = dataView.bytes();
-  if ((length * 8 >= numBits) && (_bitPosition <= static_cast<uint64_t>(length) * 8 - numBits)) {
-    uint32_t pos = 0;
-    while (pos < numBits) {
-      auto bytePosition = static_cast<uint32_t>(_bitPosition / 8);
-      auto bitPosition = static_cast<uint32_t>(_bitPosition % 8);
-      auto byte = bytes[bytePosition] >> bitPosition;
-      auto bitLength = std::min(8 - bitPosition, numBits - pos);
-      byte &= bitMasks[bitLength];
-      value |= static_cast<uint32_t>(byte) << pos;
-      pos += bitLength;
-      _bitPosition += bitLength;
-    }
-    bitPositionChanged(0);
+  if (checkBitsAvailable(numBits)) {
+    value = PeekBits(dataView.bytes(), dataView.size(), _bitPosition, numBits);
+    bitPositionChanged(numBits);
   } else {
     PAGThrowError(context, "End of file was encountered.");
   }
   return value;
 }
 
+bool DecodeStream::checkBitsAvailable(uint64_t numBits) const {
+  auto totalBits = static_cast<uint64_t>(dataView.size()) * 8;
+  return totalBits >= numBits && _bitPosition <= totalBits - numBits;
+}
+
+/**
+ * Calls body with a function that returns the next value of numBits bits each time it is called,
+ * body must not read more than numValues values. The bounds are checked once for the whole list,
+ * and the bit position is only written back after body returns. Falls back to reading the values
+ * one by one if the list runs past the end of the data, so that the error is reported the same way
+ * as before.
+ */
+template <typename Body>
+void DecodeStream::readBitsList(uint64_t numValues, uint8_t numBits, Body body) {
+  if (!checkBitsAvailable(numValues * numBits)) {
+    body([this, numBits]() { return readUBits(numBits); });
+    return;
+  }
+  auto bytes = dataView.bytes();
+  auto length = dataView.size();
+  auto bitPosition = _bitPosition;
+  body([bytes, length, numBits, &bitPosition]() {
+    auto value = PeekBits(bytes, length, bitPosition, numBits);
+    bitPosition += numBits;
+    return value;
+  });
+  bitPositionChanged(bitPosition - _bitPosition);
+}
+
 void DecodeStream::readInt32List(int32_t* values, uint32_t count) {
   auto numBits = readNumBits();
-  for (uint32_t i = 0; i < count; i++) {
-    values[i] = readBits(numBits);
-  }
+  readBitsList(count, numBits, [&](auto&& next) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = SignExtend(next(), numBits);
+    }
+  });
 }
 
 void DecodeStream::readUint32List(uint32_t* values, uint32_t count) {
   auto numBits = readNumBits();
-  for (uint32_t i = 0; i < count; i++) {
-    values[i] = readUBits(numBits);
-  }
+  readBitsList(count, numBits, [&](auto&& next) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = next();
+    }
+  });
 }
 
 void DecodeStream::readFloatList(float* values, uint32_t count, float precision) {
   auto numBits = readNumBits();
-  for (uint32_t i = 0; i < count; i++) {
-    values[i] = readBits(numBits) * precision;
-  }
+  readBitsList(count, numBits, [&](auto&& next) {
+    for (uint32_t i = 0; i < count; i++) {
+      values[i] = SignExtend(next(), numBits) * precision;
+    }
+  });
 }
+
 void DecodeStream::readPoint2DList(Point* points, uint32_t count, float precision) {
   auto numBits = readNumBits();
-  for (uint32_t i = 0; i < count; i++) {
-    points[i].x = readBits(numBits) * precision;
-    points[i].y = readBits(numBits) * precision;
-  }
+  readBitsList(static_cast<uint64_t>(count) * 2, numBits, [&](auto&& next) {
+    for (uint32_t i = 0; i < count; i++) {
+      points[i].x = SignExtend(next(), numBits) * precision;
+      points[i].y = SignExtend(next(), numBits) * precision;
+    }
+  });
 }
 
 void DecodeStream::readPoint3DList(Point3D* points, uint32_t count, float precision) {
   auto numBits = readNumBits();
-  for (uint32_t i = 0; i < count; i++) {
-    points[i].x = readBits(numBits) * precision;
-    points[i].y = readBits(numBits) * precision;
-    points[i].z = readBits(numBits) * precision;
-  }
+  readBitsList(static_cast<uint64_t>(count) * 3, numBits, [&](auto&& next) {
+    for (uint32_t i = 0; i < count; i++) {
+      points[i].x = SignExtend(next(), numBits) * precision;
+      points[i].y = SignExtend(next(), numBits) * precision;
+      points[i].z = SignExtend(next(), numBits) * precision;
+    }
+  });
 }
 
 void DecodeStream::bitPositionChanged(size_t offset) {
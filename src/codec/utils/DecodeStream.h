@@ -239,6 +239,11 @@ class DecodeStream final {
 
   void bitPositionChanged(size_t offset);
 
+  bool checkBitsAvailable(uint64_t numBits) const;
+
+  template <typename Body>
+  void readBitsList(uint64_t numValues, uint8_t numBits, Body body);
+
   void positionChanged(size_t offset);
 
   bool checkEndOfFile(uint32_t bytesToRead);
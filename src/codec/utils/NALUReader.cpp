@@ -20,18 +20,7 @@
 #include "platform/Platform.h"
 
 namespace pag {
-std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
-  auto length = stream->readEncodedUint32();
-  auto bytes = stream->readBytes(length);
-  // must check whether the bytes is valid. otherwise memcpy will crash.
-  if (length == 0 || length > bytes.length() || stream->context->hasException()) {
-    return nullptr;
-  }
-  auto data = new (std::nothrow) uint8_t[length + 4];
-  if (data == nullptr) {
-    return nullptr;
-  }
-  memcpy(data + 4, bytes.data(), length);
+void WriteStartCode(uint8_t* data, uint32_t length) {
   if (Platform::Current()->naluType() == NALUType::AVCC) {
     // AVCC
     data[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
@@ -45,6 +34,33 @@ std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
     data[2] = 0;
     data[3] = 1;
   }
+}
+
+std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream) {
+  auto length = stream->readEncodedUint32();
+  auto bytes = stream->readBytes(length);
+  // must check whether the bytes is valid. otherwise memcpy will crash.
+  if (length == 0 || length > bytes.length() || stream->context->hasException()) {
+    return nullptr;
+  }
+  auto data = new (std::nothrow) uint8_t[length + 4];
+  if (data == nullptr) {
+    return nullptr;
+  }
+  memcpy(data + 4, bytes.data(), length);
+  WriteStartCode(data, length);
   return ByteData::MakeAdopted(data, length + 4);
 }
+
+std::unique_ptr<ByteData> ReadByteDataView(DecodeStream* stream,
+                                           std::shared_ptr<ByteData> sourceBytes) {
+  auto length = stream->readEncodedUint32();
+  auto bytes = stream->readBytes(length);
+  if (length == 0 || length > bytes.length() || stream->context->hasException()) {
+    return nullptr;
+  }
+  auto data = const_cast<uint8_t*>(bytes.data());
+  // The view holds a reference to the source bytes instead of releasing anything itself.
+  return ByteData::MakeAdopted(data, length, [sourceBytes](uint8_t*) {});
+}
 }  // namespace pag
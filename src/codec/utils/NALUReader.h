@@ -22,5 +22,21 @@
 #include "codec/utils/DecodeStream.h"
 
 namespace pag {
+/**
+ * Writes the 4-byte start code (or the AVCC length prefix) of a NALU with the specified payload
+ * length to data.
+ */
+void WriteStartCode(uint8_t* data, uint32_t length);
+
+/**
+ * Reads a NALU from the stream into a new buffer, with the start code written in front of it.
+ */
 std::unique_ptr<ByteData> ReadByteDataWithStartCode(DecodeStream* stream);
+
+/**
+ * Reads a NALU from the stream as a view into sourceBytes, which must contain the bytes of the
+ * stream. The returned ByteData has no start code and keeps sourceBytes alive.
+ */
+std::unique_ptr<ByteData> ReadByteDataView(DecodeStream* stream,
+                                           std::shared_ptr<ByteData> sourceBytes);
 }
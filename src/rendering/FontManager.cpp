@@ -143,9 +143,15 @@ std::vector<std::shared_ptr<TypefaceHolder>> FontManager::getFallbackTypefaces()
   return fallbackFontList;
 }
 
+uint32_t FontManager::getFallbackGeneration() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return fallbackGeneration;
+}
+
 void FontManager::setFallbackFontNames(const std::vector<std::string>& fontNames) {
   std::lock_guard<std::mutex> autoLock(locker);
   fallbackFontList.clear();
+  fallbackGeneration++;
   for (auto& fontFamily : fontNames) {
     auto holder = TypefaceHolder::MakeFromName(fontFamily, "");
     fallbackFontList.push_back(holder);
@@ -156,6 +162,7 @@ void FontManager::setFallbackFontPaths(const std::vector<std::string>& fontPaths
                                        const std::vector<int>& ttcIndices) {
   std::lock_guard<std::mutex> autoLock(locker);
   fallbackFontList.clear();
+  fallbackGeneration++;
   int index = 0;
   for (auto& fontPath : fontPaths) {
     auto holder = TypefaceHolder::MakeFromFile(fontPath, ttcIndices[index]);
@@ -188,12 +195,21 @@ static bool RegisterFallbackFonts() {
   return Platform::Current()->registerFallbackFonts();
 }
 
-std::vector<std::shared_ptr<TypefaceHolder>> FontManager::GetFallbackTypefaces() {
+static void CheckFallbackFonts() {
   static auto registered = RegisterFallbackFonts();
   USE(registered);
+}
+
+std::vector<std::shared_ptr<TypefaceHolder>> FontManager::GetFallbackTypefaces() {
+  CheckFallbackFonts();
   return fontManager.getFallbackTypefaces();
 }
 
+uint32_t FontManager::GetFallbackGeneration() {
+  CheckFallbackFonts();
+  return fontManager.getFallbackGeneration();
+}
+
 PAGFont FontManager::RegisterFont(const std::string& fontPath, int ttcIndex,
                                   const std::string& fontFamily, const std::string& fontStyle) {
   return fontManager.registerFont(fontPath, ttcIndex, fontFamily, fontStyle);
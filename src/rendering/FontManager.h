@@ -49,6 +49,12 @@ class FontManager {
 
   static std::vector<std::shared_ptr<TypefaceHolder>> GetFallbackTypefaces();
 
+  /**
+   * Returns a number that changes every time the fallback font list is replaced, which can be used
+   * to invalidate anything derived from the previous fallback fonts.
+   */
+  static uint32_t GetFallbackGeneration();
+
   static PAGFont RegisterFont(const std::string& fontPath, int ttcIndex,
                               const std::string& fontFamily, const std::string& fontStyle);
 
@@ -83,6 +89,8 @@ class FontManager {
 
   std::vector<std::shared_ptr<TypefaceHolder>> getFallbackTypefaces();
 
+  uint32_t getFallbackGeneration();
+
   void setFallbackFontNames(const std::vector<std::string>& fontNames);
 
   void setFallbackFontPaths(const std::vector<std::string>& fontPaths,
@@ -90,6 +98,7 @@ class FontManager {
 
   std::unordered_map<std::string, std::shared_ptr<tgfx::Typeface>> registeredFontMap;
   std::vector<std::shared_ptr<TypefaceHolder>> fallbackFontList;
+  uint32_t fallbackGeneration = 0;
   std::mutex locker = {};
 
   std::shared_ptr<tgfx::Typeface> getTypefaceFromCache(const std::string& fontFamily,
@@ -0,0 +1,104 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "base/utils/Log.h"
+#include "base/utils/TimeUtil.h"
+#include "pag/file.h"
+#include "pag/pag.h"
+
+namespace pag {
+std::shared_ptr<PAGBatchRenderer> PAGBatchRenderer::Make(std::shared_ptr<File> file,
+                                                         std::shared_ptr<PAGSurface> surface) {
+  if (file == nullptr || surface == nullptr) {
+    return nullptr;
+  }
+  auto pagFile = PAGFile::MakeFrom(std::move(file));
+  if (pagFile == nullptr) {
+    return nullptr;
+  }
+  return std::shared_ptr<PAGBatchRenderer>(
+      new PAGBatchRenderer(std::move(pagFile), std::move(surface)));
+}
+
+PAGBatchRenderer::PAGBatchRenderer(std::shared_ptr<PAGFile> file,
+                                   std::shared_ptr<PAGSurface> surface)
+    : pagFile(std::move(file)) {
+  _numFrames = static_cast<int>(TimeToFrame(pagFile->duration(), pagFile->frameRate()));
+  pagPlayer = new PAGPlayer();
+  pagPlayer->setSurface(std::move(surface));
+  pagPlayer->setComposition(pagFile);
+}
+
+PAGBatchRenderer::~PAGBatchRenderer() {
+  delete pagPlayer;
+}
+
+std::shared_ptr<PAGSurface> PAGBatchRenderer::getSurface() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return pagPlayer->getSurface();
+}
+
+int PAGBatchRenderer::numFrames() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return _numFrames;
+}
+
+bool PAGBatchRenderer::render(const std::vector<PAGReplacementSet>& replacementSets,
+                              const std::function<bool(size_t, int)>& callback) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  for (size_t setIndex = 0; setIndex < replacementSets.size(); setIndex++) {
+    applyReplacementSet(replacementSets[setIndex]);
+    for (int frame = 0; frame < _numFrames; frame++) {
+      pagPlayer->setProgress(FrameToProgress(frame, _numFrames));
+      pagPlayer->flush();
+      if (callback != nullptr && !callback(setIndex, frame)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void PAGBatchRenderer::applyReplacementSet(const PAGReplacementSet& replacementSet) {
+  // Only the layers whose replacements differ from the previous instance are touched, the caches
+  // of all other layers stay valid across instances.
+  for (auto& item : currentSet.texts) {
+    if (replacementSet.texts.count(item.first) == 0) {
+      pagFile->replaceText(item.first, nullptr);
+    }
+  }
+  for (auto& item : replacementSet.texts) {
+    auto result = currentSet.texts.find(item.first);
+    if (result == currentSet.texts.end() || result->second != item.second) {
+      pagFile->replaceText(item.first, item.second);
+    }
+  }
+  for (auto& item : currentSet.images) {
+    if (replacementSet.images.count(item.first) == 0) {
+      pagFile->replaceImage(item.first, nullptr);
+    }
+  }
+  for (auto& item : replacementSet.images) {
+    auto result = currentSet.images.find(item.first);
+    if (result == currentSet.images.end() || result->second != item.second) {
+      pagFile->replaceImage(item.first, item.second);
+    }
+  }
+  currentSet = replacementSet;
+}
+}  // namespace pag
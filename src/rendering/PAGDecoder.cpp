@@ -17,17 +17,110 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <platform/Platform.h>
+#include <condition_variable>
+#include <thread>
 #include "base/utils/Log.h"
 #include "base/utils/TGFXCast.h"
 #include "base/utils/TimeUtil.h"
 #include "pag/pag.h"
 #include "rendering/CompositionReader.h"
 #include "rendering/caches/DiskCache.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/layers/ContentVersion.h"
 #include "rendering/utils/BitmapBuffer.h"
 #include "rendering/utils/LockGuard.h"
+#include "rendering/utils/VaryingTimeRanges.h"
+#include "tgfx/utils/Buffer.h"
+#include "tgfx/utils/Task.h"
 
 namespace pag {
+/**
+ * FrameQueue hands out frames to the worker threads and keeps the rendered frames in a bounded ring
+ * of pixel buffers until they are consumed in order.
+ */
+class FrameQueue {
+ public:
+  FrameQueue(const tgfx::ImageInfo& info, size_t numSlots, size_t numFrames)
+      : info(info), slots(numSlots), states(numFrames, FrameState::Pending) {
+    for (auto& slot : slots) {
+      slot.alloc(info.byteSize());
+    }
+  }
+
+  bool isValid() const {
+    for (auto& slot : slots) {
+      if (slot.isEmpty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Returns the position of the next frame to render, or -1 if all frames are handed out or the
+   * queue is stopped. Blocks while the ring of pixel buffers is full.
+   */
+  int acquire() {
+    std::unique_lock<std::mutex> autoLock(locker);
+    condition.wait(autoLock, [&] {
+      return stopped || nextPosition >= states.size() || nextPosition < consumed + slots.size();
+    });
+    if (stopped || nextPosition >= states.size()) {
+      return -1;
+    }
+    return static_cast<int>(nextPosition++);
+  }
+
+  std::shared_ptr<BitmapBuffer> bitmapAt(size_t position) {
+    return BitmapBuffer::Wrap(info, slots[position % slots.size()].bytes());
+  }
+
+  void commit(size_t position, bool success) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    states[position] = success ? FrameState::Ready : FrameState::Failed;
+    condition.notify_all();
+  }
+
+  /**
+   * Waits until the frame at the specified position is rendered and returns its pixels. Returns
+   * nullptr if the frame fails to render.
+   */
+  const void* wait(size_t position) {
+    std::unique_lock<std::mutex> autoLock(locker);
+    condition.wait(autoLock, [&] { return states[position] != FrameState::Pending; });
+    if (states[position] == FrameState::Failed) {
+      return nullptr;
+    }
+    return slots[position % slots.size()].bytes();
+  }
+
+  /**
+   * Returns the pixel buffer of the frame at the specified position back to the ring.
+   */
+  void release(size_t position) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    consumed = position + 1;
+    condition.notify_all();
+  }
+
+  void stop() {
+    std::lock_guard<std::mutex> autoLock(locker);
+    stopped = true;
+    condition.notify_all();
+  }
+
+ private:
+  enum class FrameState { Pending, Ready, Failed };
+
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  tgfx::ImageInfo info = {};
+  std::vector<tgfx::Buffer> slots = {};
+  std::vector<FrameState> states = {};
+  size_t nextPosition = 0;
+  size_t consumed = 0;
+  bool stopped = false;
+};
 
 static std::string DefaultCacheKeyGeneratorFunc(PAGDecoder* decoder,
                                                 std::shared_ptr<PAGComposition> composition) {
@@ -78,13 +171,31 @@ std::vector<TimeRange> PAGDecoder::GetStaticTimeRange(std::shared_ptr<PAGComposi
   std::vector<TimeRange> timeRanges = {};
   auto startTime = composition->startTimeInternal();
   auto duration = composition->durationInternal();
+  // Derives the changes from the static time ranges of the layer caches if possible, which avoids
+  // stepping the whole layer tree through every frame. The ranges are collected from the whole tree
+  // again after any edit, not only from the edited subtree. That costs one pass over the layers,
+  // since the change ranges of every layer cache are computed once when it is created.
+  VaryingTimeRanges varyingRanges = {};
+  auto analytic = composition->collectVaryingTimeRanges(0, &varyingRanges);
+  auto lastLayerTime = startTime;
   auto oldLayerTime = composition->currentTimeInternal();
-  composition->gotoTime(startTime);
+  if (!analytic) {
+    composition->gotoTime(startTime);
+  }
   TimeRange timeRange = {0, 0};
   for (int i = 1; i < numFrames; i++) {
     auto progress = FrameToProgress(static_cast<Frame>(i), numFrames);
     auto layerTime = startTime + ProgressToTime(progress, duration);
-    if (!composition->gotoTime(layerTime)) {
+    auto changed = false;
+    if (analytic) {
+      changed = varyingRanges.changed(lastLayerTime, layerTime);
+    } else {
+      // Pins the frames of one step at a time, the sweep may visit more frames than the budgets.
+      FrameCachePins framePins = {};
+      changed = composition->gotoTime(layerTime);
+    }
+    lastLayerTime = layerTime;
+    if (!changed) {
       timeRange.end++;
       continue;
     }
@@ -96,7 +207,9 @@ std::vector<TimeRange> PAGDecoder::GetStaticTimeRange(std::shared_ptr<PAGComposi
   if (timeRange.duration() > 1) {
     timeRanges.push_back(timeRange);
   }
-  composition->gotoTime(oldLayerTime);
+  if (!analytic) {
+    composition->gotoTime(oldLayerTime);
+  }
   return timeRanges;
 }
 
@@ -207,6 +320,157 @@ bool PAGDecoder::readFrameInternal(int index, std::shared_ptr<BitmapBuffer> bitm
   return success;
 }
 
+bool PAGDecoder::readFrames(int startIndex, int endIndex, size_t rowBytes,
+                            const std::function<bool(int, const void*)>& callback, int maxWorkers,
+                            ColorType colorType, AlphaType alphaType) {
+  std::lock_guard<std::mutex> auoLock(locker);
+  if (callback == nullptr) {
+    LOGE("PAGDecoder::readFrames() The specified callback is invalid!");
+    return false;
+  }
+  auto composition = getComposition();
+  checkCompositionChange(composition);
+  if (startIndex < 0 || startIndex >= endIndex || endIndex > _numFrames) {
+    LOGE("PAGDecoder::readFrames() The index range is out of range!");
+    return false;
+  }
+  auto info =
+      tgfx::ImageInfo::Make(_width, _height, ToTGFX(colorType), ToTGFX(alphaType), rowBytes);
+  if (info.isEmpty()) {
+    LOGE("PAGDecoder::readFrames() The specified rowBytes is invalid!");
+    return false;
+  }
+  if (!checkSequenceFile(composition, info)) {
+    return false;
+  }
+  // Frames within the same static time range share one rendering.
+  std::vector<TimeRange> frameRanges = {};
+  for (auto index = startIndex; index < endIndex;) {
+    auto timeRange = GetTimeRangeContains(staticTimeRanges, index);
+    auto lastIndex = std::min(static_cast<int>(timeRange.end), endIndex - 1);
+    frameRanges.push_back({index, lastIndex});
+    index = lastIndex + 1;
+  }
+  if (maxWorkers <= 0) {
+    maxWorkers = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  auto numWorkers = std::min(maxWorkers, static_cast<int>(frameRanges.size()));
+  checkWorkerReaders(composition, numWorkers);
+  if (workerReaders.empty()) {
+    return readFramesSerially(frameRanges, info, callback);
+  }
+  auto success = readFramesInParallel(frameRanges, info, callback);
+  if (sequenceFile->isComplete()) {
+    workerReaders = {};
+  }
+  return success;
+}
+
+bool PAGDecoder::readFramesInParallel(const std::vector<TimeRange>& frameRanges,
+                                      const tgfx::ImageInfo& info,
+                                      const std::function<bool(int, const void*)>& callback) {
+  FrameQueue queue(info, workerReaders.size() * 2, frameRanges.size());
+  if (!queue.isValid()) {
+    LOGE("PAGDecoder::readFrames() Failed to allocate the frame buffers!");
+    return false;
+  }
+  auto numFrames = _numFrames;
+  auto sequence = sequenceFile;
+  std::vector<std::shared_ptr<tgfx::Task>> tasks = {};
+  for (auto& workerReader : workerReaders) {
+    auto task = tgfx::Task::Run([&, workerReader]() {
+      auto position = queue.acquire();
+      while (position >= 0) {
+        auto index = static_cast<int>(frameRanges[position].start);
+        auto bitmap = queue.bitmapAt(position);
+        auto success = sequence->readFrame(index, bitmap);
+        if (!success) {
+          auto progress = FrameToProgress(static_cast<Frame>(index), numFrames);
+          success = workerReader->readFrame(progress, bitmap);
+          if (success && !sequence->writeFrame(index, bitmap)) {
+            LOGE("PAGDecoder::readFrames() Failed to write frame to SequenceFile!");
+          }
+        }
+        queue.commit(position, success);
+        position = queue.acquire();
+      }
+    });
+    tasks.push_back(task);
+  }
+  auto success = true;
+  for (size_t position = 0; position < frameRanges.size(); position++) {
+    auto pixels = queue.wait(position);
+    if (pixels == nullptr) {
+      LOGE("PAGDecoder::readFrames() Failed to render frame %d!",
+           static_cast<int>(frameRanges[position].start));
+      success = false;
+      break;
+    }
+    auto keepReading = true;
+    const auto& frameRange = frameRanges[position];
+    for (auto index = frameRange.start; index <= frameRange.end && keepReading; index++) {
+      keepReading = callback(static_cast<int>(index), pixels);
+      lastReadIndex = static_cast<int>(index);
+    }
+    queue.release(position);
+    if (!keepReading) {
+      break;
+    }
+  }
+  queue.stop();
+  for (auto& task : tasks) {
+    task->wait();
+  }
+  return success;
+}
+
+bool PAGDecoder::readFramesSerially(const std::vector<TimeRange>& frameRanges,
+                                    const tgfx::ImageInfo& info,
+                                    const std::function<bool(int, const void*)>& callback) {
+  tgfx::Buffer buffer(info.byteSize());
+  if (buffer.isEmpty()) {
+    LOGE("PAGDecoder::readFrames() Failed to allocate the frame buffer!");
+    return false;
+  }
+  auto bitmap = BitmapBuffer::Wrap(info, buffer.bytes());
+  for (auto& frameRange : frameRanges) {
+    if (!readFrameInternal(static_cast<int>(frameRange.start), bitmap)) {
+      return false;
+    }
+    for (auto index = frameRange.start; index <= frameRange.end; index++) {
+      auto keepReading = callback(static_cast<int>(index), buffer.bytes());
+      lastReadIndex = static_cast<int>(index);
+      if (!keepReading) {
+        return true;
+      }
+    }
+  }
+  return true;
+}
+
+void PAGDecoder::checkWorkerReaders(std::shared_ptr<PAGComposition> composition, int numWorkers) {
+  if (numWorkers <= 1 || composition == nullptr || !composition->isPAGFile()) {
+    workerReaders = {};
+    return;
+  }
+  while (workerReaders.size() < static_cast<size_t>(numWorkers)) {
+    auto pagFile = std::static_pointer_cast<PAGFile>(composition)->copyWithEdits();
+    if (pagFile == nullptr) {
+      break;
+    }
+    auto workerReader = CompositionReader::Make(_width, _height);
+    if (workerReader == nullptr) {
+      LOGE("PAGDecoder::readFrames() Failed to create a CompositionReader!");
+      break;
+    }
+    workerReader->setComposition(pagFile);
+    workerReaders.push_back(workerReader);
+  }
+  if (workerReaders.size() > static_cast<size_t>(numWorkers)) {
+    workerReaders.resize(static_cast<size_t>(numWorkers));
+  }
+}
+
 bool PAGDecoder::renderFrame(std::shared_ptr<PAGComposition> composition, int index,
                              std::shared_ptr<BitmapBuffer> bitmap) {
   if (composition == nullptr) {
@@ -264,6 +528,7 @@ void PAGDecoder::checkCompositionChange(std::shared_ptr<PAGComposition> composit
     return;
   }
   sequenceFile = nullptr;
+  workerReaders = {};
   lastContentVersion = contentVersion;
   lastReadIndex = -1;
   auto result = GetFrameCountAndRate(composition, maxFrameRate);
@@ -18,6 +18,7 @@
 
 #include "pag/pag.h"
 #include "rendering/FontManager.h"
+#include "rendering/utils/shaper/TextShaper.h"
 
 namespace pag {
 PAGFont PAGFont::RegisterFont(const std::string& fontPath, int ttcIndex,
@@ -42,4 +43,12 @@ void PAGFont::SetFallbackFontPaths(const std::vector<std::string>& fontPaths,
                                    const std::vector<int>& ttcIndices) {
   FontManager::SetFallbackFontPaths(fontPaths, ttcIndices);
 }
+
+size_t PAGFont::MaxShapingFontCount() {
+  return TextShaper::FontCacheCapacity();
+}
+
+void PAGFont::SetMaxShapingFontCount(size_t count) {
+  TextShaper::SetFontCacheCapacity(count);
+}
 }  // namespace pag
\ No newline at end of file
@@ -19,10 +19,12 @@
 #include "base/utils/TimeUtil.h"
 #include "pag/file.h"
 #include "rendering/FileReporter.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/drawables/Drawable.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/utils/ApplyScaleMode.h"
+#include "rendering/utils/DamageTracker.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
 #include "tgfx/utils/Clock.h"
@@ -39,6 +41,7 @@ PAGPlayer::~PAGPlayer() {
   setSurface(nullptr);
   stage->removeAllLayers();
   delete reporter;
+  delete damageTracker;
 }
 
 std::shared_ptr<PAGComposition> PAGPlayer::getComposition() {
@@ -95,6 +98,7 @@ void PAGPlayer::setSurfaceInternal(std::shared_ptr<PAGSurface> newSurface) {
   if (pagSurface) {
     pagSurface->pagPlayer = this;
     pagSurface->contentVersion = 0;
+    pagSurface->lastSurface.reset();
     pagSurface->rootLocker = rootLocker;
     updateStageSize();
   } else {
@@ -256,8 +260,27 @@ void PAGPlayer::setAutoClear(bool value) {
   stage->notifyModified(true);
 }
 
+bool PAGPlayer::incrementalRendering() {
+  LockGuard autoLock(rootLocker);
+  return damageTracker != nullptr;
+}
+
+void PAGPlayer::setIncrementalRendering(bool value) {
+  LockGuard autoLock(rootLocker);
+  if (value == (damageTracker != nullptr)) {
+    return;
+  }
+  if (value) {
+    damageTracker = new DamageTracker();
+  } else {
+    delete damageTracker;
+    damageTracker = nullptr;
+  }
+}
+
 void PAGPlayer::prepare() {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   prepareInternal();
   if (pagSurface != nullptr && pagSurface->prepare(renderCache, lastGraphic)) {
     return;
@@ -273,6 +296,9 @@ void PAGPlayer::prepareInternal() {
     Recorder recorder = {};
     stage->draw(&recorder);
     lastGraphic = recorder.makeGraphic();
+    if (damageTracker != nullptr) {
+      damageTracker->update(stage.get());
+    }
   }
 }
 
@@ -285,25 +311,52 @@ bool PAGPlayer::wait(const BackendSemaphore& waitSemaphore) {
 }
 
 bool PAGPlayer::flushAndSignalSemaphore(BackendSemaphore* signalSemaphore) {
-  LockGuard autoLock(rootLocker);
-  return flushInternal(signalSemaphore);
+  return flushAndNotify(signalSemaphore);
 }
 
 bool PAGPlayer::flush() {
-  LockGuard autoLock(rootLocker);
-  return flushInternal(nullptr);
+  return flushAndNotify(nullptr);
+}
+
+bool PAGPlayer::flushAndNotify(BackendSemaphore* signalSemaphore) {
+  std::function<void(size_t)> callback = nullptr;
+  size_t memoryUsage = 0;
+  bool result = false;
+  {
+    LockGuard autoLock(rootLocker);
+    result = flushInternal(signalSemaphore);
+    if (memoryPressureCallback && renderCache->memoryPressure()) {
+      callback = memoryPressureCallback;
+      memoryUsage = renderCache->memoryUsage();
+    }
+  }
+  // The callback is called outside the lock, so it can purge or reconfigure this player.
+  if (callback) {
+    callback(memoryUsage);
+  }
+  return result;
 }
 
 bool PAGPlayer::flushInternal(BackendSemaphore* signalSemaphore) {
   if (pagSurface == nullptr) {
     return false;
   }
+  // The frames looked up while recording and drawing stay alive until the frame is flushed.
+  FrameCachePins framePins = {};
   tgfx::Clock clock = {};
   prepareInternal();
   clock.mark("rendering");
-  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear)) {
+  const tgfx::Rect* damagedRegion = nullptr;
+  if (damageTracker != nullptr && !damageTracker->fullyDamaged()) {
+    damagedRegion = &damageTracker->damagedBounds();
+  }
+  if (!pagSurface->draw(renderCache, lastGraphic, signalSemaphore, _autoClear, damagedRegion)) {
     return false;
   }
+  if (damageTracker != nullptr) {
+    // The damage collected so far has been drawn, even if the surface was redrawn as a whole.
+    damageTracker->clearDamage();
+  }
   clock.mark("presenting");
   renderCache->renderingTime = clock.measure("", "rendering");
   renderCache->presentingTime = clock.measure("rendering", "presenting");
@@ -327,6 +380,7 @@ Rect PAGPlayer::getBounds(std::shared_ptr<PAGLayer> pagLayer) {
     return Rect::MakeEmpty();
   }
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   updateStageSize();
   tgfx::Rect bounds = {};
   pagLayer->measureBounds(&bounds);
@@ -351,6 +405,7 @@ Rect PAGPlayer::getBounds(std::shared_ptr<PAGLayer> pagLayer) {
 std::vector<std::shared_ptr<PAGLayer>> PAGPlayer::getLayersUnderPoint(float surfaceX,
                                                                       float surfaceY) {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   updateStageSize();
   std::vector<std::shared_ptr<PAGLayer>> results;
   stage->getLayersUnderPointInternal(surfaceX, surfaceY, &results);
@@ -360,6 +415,7 @@ std::vector<std::shared_ptr<PAGLayer>> PAGPlayer::getLayersUnderPoint(float surf
 bool PAGPlayer::hitTestPoint(std::shared_ptr<PAGLayer> pagLayer, float surfaceX, float surfaceY,
                              bool pixelHitTest) {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   updateStageSize();
   auto local = pagLayer->globalToLocalPoint(surfaceX, surfaceY);
   if (!pixelHitTest) {
@@ -409,6 +465,47 @@ int64_t PAGPlayer::graphicsMemory() {
   return renderCache->memoryUsage();
 }
 
+size_t PAGPlayer::softMemoryLimit() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->softMemoryLimit();
+}
+
+void PAGPlayer::setSoftMemoryLimit(size_t bytes) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setSoftMemoryLimit(bytes);
+}
+
+size_t PAGPlayer::hardMemoryLimit() {
+  LockGuard autoLock(rootLocker);
+  return renderCache->hardMemoryLimit();
+}
+
+void PAGPlayer::setHardMemoryLimit(size_t bytes) {
+  LockGuard autoLock(rootLocker);
+  renderCache->setHardMemoryLimit(bytes);
+}
+
+size_t PAGPlayer::purgeCache(size_t bytes) {
+  LockGuard autoLock(rootLocker);
+  if (pagSurface == nullptr) {
+    return 0;
+  }
+  auto context = pagSurface->lockContext();
+  if (context == nullptr) {
+    return 0;
+  }
+  renderCache->attachToContext(context, false);
+  auto releasedMemory = renderCache->purge(bytes);
+  renderCache->detachFromContext();
+  pagSurface->unlockContext();
+  return releasedMemory;
+}
+
+void PAGPlayer::setMemoryPressureCallback(std::function<void(size_t memoryUsage)> callback) {
+  LockGuard autoLock(rootLocker);
+  memoryPressureCallback = std::move(callback);
+}
+
 bool PAGPlayer::updateStageSize() {
   if (pagSurface == nullptr) {
     return false;
@@ -20,6 +20,7 @@
 #include "pag/pag.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/drawables/Drawable.h"
+#include "rendering/drawables/PixelBufferDrawable.h"
 #include "rendering/graphics/Recorder.h"
 #include "rendering/utils/GLRestorer.h"
 #include "rendering/utils/LockGuard.h"
@@ -83,6 +84,8 @@ bool PAGSurface::clearAll() {
     return false;
   }
   contentVersion = 0;  // 清空画布后 contentVersion 还原为初始值 0.
+  lastSurface.reset();
+  lastDamagedBounds = Rect::MakeEmpty();
   auto canvas = surface->getCanvas();
   canvas->clear();
   surface->flush();
@@ -191,8 +194,46 @@ bool PAGSurface::readPixels(ColorType colorType, AlphaType alphaType, void* dstP
   return result;
 }
 
+bool PAGSurface::readPixels(ColorType colorType, AlphaType alphaType, void* dstPixels,
+                            size_t dstRowBytes, const Rect& srcRect) {
+  LockGuard autoLock(rootLocker);
+  auto context = lockContext();
+  if (context == nullptr) {
+    return false;
+  }
+  auto surface = drawable->getSurface(context, true);
+  if (surface == nullptr) {
+    unlockContext();
+    return false;
+  }
+  auto rect = ToTGFX(srcRect);
+  rect.roundOut();
+  if (!rect.intersect(tgfx::Rect::MakeWH(surface->width(), surface->height()))) {
+    unlockContext();
+    return false;
+  }
+  auto info = tgfx::ImageInfo::Make(static_cast<int>(rect.width()), static_cast<int>(rect.height()),
+                                    ToTGFX(colorType), ToTGFX(alphaType), dstRowBytes);
+  auto result = surface->readPixels(info, dstPixels, static_cast<int>(rect.left),
+                                    static_cast<int>(rect.top));
+  unlockContext();
+  return result;
+}
+
+Rect PAGSurface::damagedBounds() {
+  LockGuard autoLock(rootLocker);
+  return lastDamagedBounds;
+}
+
+void PAGSurface::releaseBuffer(int bufferIndex) {
+  if (pixelBufferDrawable != nullptr) {
+    pixelBufferDrawable->releaseBuffer(bufferIndex);
+  }
+}
+
 bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
-                      BackendSemaphore* signalSemaphore, bool autoClear) {
+                      BackendSemaphore* signalSemaphore, bool autoClear,
+                      const tgfx::Rect* damagedRegion) {
   auto context = lockContext();
   if (!context) {
     return false;
@@ -213,10 +254,38 @@ bool PAGSurface::draw(RenderCache* cache, std::shared_ptr<Graphic> graphic,
   contentVersion = cache->getContentVersion();
   cache->attachToContext(context);
   auto canvas = surface->getCanvas();
+  auto surfaceBounds = tgfx::Rect::MakeWH(surface->width(), surface->height());
+  auto drawBounds = surfaceBounds;
+  // The damaged region can be redrawn alone only if the surface still holds the last frame.
+  if (autoClear && damagedRegion != nullptr && drawable->preservesContent() &&
+      lastSurface.lock() == surface) {
+    drawBounds = *damagedRegion;
+    drawBounds.roundOut();
+    // Leaves room for the antialiased edges.
+    drawBounds.outset(1, 1);
+    if (!drawBounds.intersect(surfaceBounds)) {
+      drawBounds.setEmpty();
+    }
+  }
+  if (drawBounds == surfaceBounds) {
+    if (autoClear) {
+      canvas->clear();
+    }
+    onDraw(graphic, surface, cache);
+  } else if (!drawBounds.isEmpty()) {
+    canvas->clearRect(drawBounds, tgfx::Color::Transparent());
+    canvas->save();
+    canvas->clipRect(drawBounds);
+    onDraw(graphic, surface, cache);
+    canvas->restore();
+  }
   if (autoClear) {
-    canvas->clear();
+    lastSurface = surface;
+  } else {
+    // The pixels drawn without clearing do not match any single frame.
+    lastSurface.reset();
   }
-  onDraw(graphic, surface, cache);
+  lastDamagedBounds = ToPAG(drawBounds);
   if (signalSemaphore == nullptr) {
     surface->flush();
   } else {
@@ -21,6 +21,7 @@
 #include "pag/pag.h"
 #include "rendering/drawables/HardwareBufferDrawable.h"
 #include "rendering/drawables/OffscreenDrawable.h"
+#include "rendering/drawables/PixelBufferDrawable.h"
 #include "rendering/drawables/RenderTargetDrawable.h"
 #include "rendering/drawables/TextureDrawable.h"
 #include "tgfx/opengl/GLDevice.h"
@@ -67,6 +68,21 @@ std::shared_ptr<PAGSurface> PAGSurface::MakeOffscreen(int width, int height) {
   return MakeFrom(drawable);
 }
 
+std::shared_ptr<PAGSurface> PAGSurface::MakeOffscreen(int width, int height,
+                                                      const std::vector<void*>& buffers,
+                                                      size_t rowBytes,
+                                                      std::function<void(int)> frameReady,
+                                                      ColorType colorType, AlphaType alphaType) {
+  auto info = tgfx::ImageInfo::Make(width, height, ToTGFX(colorType), ToTGFX(alphaType), rowBytes);
+  auto drawable = PixelBufferDrawable::Make(width, height, buffers, info, std::move(frameReady));
+  if (drawable == nullptr) {
+    return nullptr;
+  }
+  auto surface = std::shared_ptr<PAGSurface>(new PAGSurface(drawable));
+  surface->pixelBufferDrawable = drawable.get();
+  return surface;
+}
+
 std::shared_ptr<PAGSurface> PAGSurface::MakeFrom(HardwareBufferRef hardwareBuffer) {
   auto drawable = HardwareBufferDrawable::MakeFrom(hardwareBuffer);
   return MakeFrom(drawable);
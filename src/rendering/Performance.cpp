@@ -52,5 +52,8 @@ void Performance::resetPerformance() {
   hardwareDecodingInitialTime = 0;
   softwareDecodingInitialTime = 0;
   totalTime = 0;
+  prefetchedFrames = 0;
+  pooledDecoderHits = 0;
+  pooledDecoderMisses = 0;
 }
 }  // namespace pag
\ No newline at end of file
@@ -39,6 +39,12 @@ class Performance {
   int64_t hardwareDecodingInitialTime = 0;
   int64_t softwareDecodingInitialTime = 0;
   int64_t totalTime = 0;
+  // The number of sequence frames that have been decoded ahead and are waiting to be rendered.
+  int64_t prefetchedFrames = 0;
+  // The number of video decoders taken from the VideoDecoderPool instead of being created.
+  int64_t pooledDecoderHits = 0;
+  // The number of video decoders created while the VideoDecoderPool is enabled.
+  int64_t pooledDecoderMisses = 0;
 
   /**
    * Returns the formatted  string which contains the performance data.
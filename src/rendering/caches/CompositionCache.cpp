@@ -22,11 +22,17 @@
 namespace pag {
 
 CompositionCache* CompositionCache::Get(Composition* composition) {
+  auto cache = composition->cache.load(std::memory_order_acquire);
+  if (cache != nullptr) {
+    return static_cast<CompositionCache*>(cache);
+  }
   std::lock_guard<std::mutex> autoLock(composition->locker);
-  if (composition->cache == nullptr) {
-    composition->cache = new CompositionCache(composition);
+  cache = composition->cache.load(std::memory_order_relaxed);
+  if (cache == nullptr) {
+    cache = new CompositionCache(composition);
+    composition->cache.store(cache, std::memory_order_release);
   }
-  return static_cast<CompositionCache*>(composition->cache);
+  return static_cast<CompositionCache*>(cache);
 }
 
 CompositionCache::CompositionCache(Composition* composition) : composition(composition) {
@@ -40,13 +46,20 @@ std::shared_ptr<Graphic> CompositionCache::getContent(Frame contentFrame) {
   if (contentFrame < 0) {
     contentFrame = 0;
   }
-  std::lock_guard<std::mutex> autoLock(locker);
-  auto cache = frames[contentFrame];
-  if (cache == nullptr) {
-    cache = createContent(contentFrame);
-    frames[contentFrame] = cache;
+  {
+    std::shared_lock<std::shared_mutex> autoLock(locker);
+    auto result = frames.find(contentFrame);
+    if (result != frames.end()) {
+      return result->second;
+    }
   }
-  return cache;
+  // Renders the frame outside the lock, so that threads rendering different frames of the same
+  // composition do not wait for each other. If two threads render the same frame at once, the
+  // first one to finish wins.
+  auto cache = createContent(contentFrame);
+  std::lock_guard<std::shared_mutex> autoLock(locker);
+  auto result = frames.emplace(contentFrame, cache);
+  return result.first->second;
 }
 
 std::shared_ptr<Graphic> CompositionCache::createContent(Frame compositionFrame) {
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <shared_mutex>
 #include <unordered_map>
 #include "pag/file.h"
 #include "rendering/graphics/Graphic.h"
@@ -33,7 +34,7 @@ class CompositionCache : public Cache {
   std::shared_ptr<Graphic> createContent(Frame compositionFrame);
 
  private:
-  std::mutex locker = {};
+  std::shared_mutex locker = {};
   Composition* composition = nullptr;
   std::unordered_map<Frame, std::shared_ptr<Graphic>> frames;
 
@@ -24,6 +24,11 @@ ContentCache::ContentCache(Layer* layer)
     : FrameCache<Content>(layer->startTime, layer->duration), layer(layer) {
 }
 
+size_t ContentCache::measureMemory(Content* content) const {
+  auto graphic = static_cast<GraphicContent*>(content)->graphic;
+  return sizeof(GraphicContent) + (graphic ? graphic->memoryUsage() : 0);
+}
+
 void ContentCache::update() {
   staticTimeRanges = {layer->visibleRange()};
   excludeVaryingRanges(&staticTimeRanges);
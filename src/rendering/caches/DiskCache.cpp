@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "DiskCache.h"
+#include <algorithm>
 #include "pag/pag.h"
 #include "platform/Platform.h"
 #include "rendering/utils/Directory.h"
@@ -45,6 +46,22 @@ void PAGDiskCache::SetMaxDiskSize(size_t size) {
   DiskCache::GetInstance()->setMaxDiskSize(size);
 }
 
+DiskCacheCompression PAGDiskCache::Compression() {
+  return DiskCache::GetInstance()->getCompression();
+}
+
+void PAGDiskCache::SetCompression(DiskCacheCompression compression) {
+  DiskCache::GetInstance()->setCompression(compression);
+}
+
+int PAGDiskCache::KeyframeInterval() {
+  return DiskCache::GetInstance()->getKeyframeInterval();
+}
+
+void PAGDiskCache::SetKeyframeInterval(int interval) {
+  DiskCache::GetInstance()->setKeyframeInterval(interval);
+}
+
 void PAGDiskCache::RemoveAll() {
   DiskCache::GetInstance()->removeAll();
 }
@@ -93,6 +110,31 @@ void DiskCache::setMaxDiskSize(size_t size) {
   }
 }
 
+DiskCacheCompression DiskCache::getCompression() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return compressionType == CompressionType::ZSTD ? DiskCacheCompression::ZSTD
+                                                  : DiskCacheCompression::LZ4;
+}
+
+void DiskCache::setCompression(DiskCacheCompression compression) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  compressionType = FrameCodec::DefaultType();
+  if (compression == DiskCacheCompression::ZSTD &&
+      FrameCodec::Make(CompressionType::ZSTD) != nullptr) {
+    compressionType = CompressionType::ZSTD;
+  }
+}
+
+int DiskCache::getKeyframeInterval() {
+  std::lock_guard<std::mutex> autoLock(locker);
+  return keyframeInterval;
+}
+
+void DiskCache::setKeyframeInterval(int interval) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  keyframeInterval = std::max(interval, 0);
+}
+
 void DiskCache::removeAll() {
   std::lock_guard<std::mutex> autoLock(locker);
   if (cacheFolder.empty()) {
@@ -134,7 +176,8 @@ std::shared_ptr<SequenceFile> DiskCache::openSequence(
     }
   }
   auto filePath = fileIDToPath(fileID);
-  auto sequenceFile = SequenceFile::Open(filePath, info, frameCount, frameRate, staticTimeRanges);
+  auto sequenceFile = SequenceFile::Open(filePath, info, frameCount, frameRate, staticTimeRanges,
+                                         compressionType, keyframeInterval);
   if (sequenceFile == nullptr) {
     return nullptr;
   }
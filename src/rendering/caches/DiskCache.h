@@ -21,6 +21,7 @@
 #include <list>
 #include <unordered_map>
 #include "SequenceFile.h"
+#include "pag/pag.h"
 #include "pag/types.h"
 
 namespace pag {
@@ -56,6 +57,8 @@ class DiskCache {
   uint32_t fileIDCount = 1;
   size_t totalDiskSize = 0;
   size_t maxDiskSize = 1073741824;  // 1 GB
+  CompressionType compressionType = FrameCodec::DefaultType();
+  int keyframeInterval = 0;
   std::unordered_map<std::string, uint32_t> cachedFileIDs = {};
   std::unordered_map<uint32_t, std::shared_ptr<FileInfo>> cachedFileInfos = {};
   std::list<std::shared_ptr<FileInfo>> cachedFiles = {};
@@ -67,6 +70,10 @@ class DiskCache {
 
   size_t getMaxDiskSize();
   void setMaxDiskSize(size_t size);
+  DiskCacheCompression getCompression();
+  void setCompression(DiskCacheCompression compression);
+  int getKeyframeInterval();
+  void setKeyframeInterval(int interval);
   void removeAll();
   std::shared_ptr<SequenceFile> openSequence(const std::string& key, const tgfx::ImageInfo& info,
                                              int frameCount, float frameRate,
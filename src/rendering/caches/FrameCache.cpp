@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2021 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCache.h"
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+#include "pag/pag.h"
+
+namespace pag {
+static std::atomic<size_t> maxCacheMemory = {0};
+static std::atomic<size_t> maxTotalMemory = {0};
+static std::atomic<size_t> totalMemory = {0};
+
+struct PinnedCaches {
+  int scopeCount = 0;
+  std::unordered_set<void*> keys = {};
+  std::vector<std::shared_ptr<void>> caches = {};
+};
+
+static PinnedCaches& CurrentPins() {
+  static thread_local PinnedCaches pinnedCaches = {};
+  return pinnedCaches;
+}
+
+size_t PAGFrameCache::MaxCacheMemory() {
+  return FrameCacheBudget::MaxCacheMemory();
+}
+
+void PAGFrameCache::SetMaxCacheMemory(size_t bytes) {
+  FrameCacheBudget::SetMaxCacheMemory(bytes);
+}
+
+size_t PAGFrameCache::MaxTotalMemory() {
+  return FrameCacheBudget::MaxTotalMemory();
+}
+
+void PAGFrameCache::SetMaxTotalMemory(size_t bytes) {
+  FrameCacheBudget::SetMaxTotalMemory(bytes);
+}
+
+size_t PAGFrameCache::TotalMemory() {
+  return FrameCacheBudget::TotalMemory();
+}
+
+size_t FrameCacheBudget::MaxCacheMemory() {
+  return maxCacheMemory;
+}
+
+size_t FrameCacheBudget::MaxTotalMemory() {
+  return maxTotalMemory;
+}
+
+size_t FrameCacheBudget::TotalMemory() {
+  return totalMemory;
+}
+
+void FrameCacheBudget::SetMaxCacheMemory(size_t bytes) {
+  maxCacheMemory = bytes;
+}
+
+void FrameCacheBudget::SetMaxTotalMemory(size_t bytes) {
+  maxTotalMemory = bytes;
+}
+
+bool FrameCacheBudget::Enabled() {
+  return maxCacheMemory > 0 || maxTotalMemory > 0;
+}
+
+void FrameCacheBudget::Allocate(size_t bytes) {
+  totalMemory += bytes;
+}
+
+void FrameCacheBudget::Release(size_t bytes) {
+  totalMemory -= bytes;
+}
+
+FrameCachePins::FrameCachePins() {
+  CurrentPins().scopeCount++;
+}
+
+FrameCachePins::~FrameCachePins() {
+  auto& pins = CurrentPins();
+  if (--pins.scopeCount == 0 && !pins.caches.empty()) {
+    pins.keys.clear();
+    pins.caches.clear();
+  }
+}
+
+void FrameCachePins::Pin(std::shared_ptr<void> cache) {
+  auto& pins = CurrentPins();
+  if (pins.scopeCount == 0 || !pins.keys.insert(cache.get()).second) {
+    return;
+  }
+  pins.caches.push_back(std::move(cache));
+}
+
+size_t FrameCachePins::PinnedCount() {
+  return CurrentPins().caches.size();
+}
+}  // namespace pag
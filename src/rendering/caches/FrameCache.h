@@ -18,10 +18,76 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include "pag/file.h"
 
 namespace pag {
+/**
+ * FrameCacheBudget tracks the memory budgets shared by all FrameCaches. Both budgets are disabled
+ * (zero) by default, which means the caches keep every frame until their layers are released.
+ */
+class FrameCacheBudget {
+ public:
+  /**
+   * Returns the memory limit of a single FrameCache in bytes, zero means unlimited.
+   */
+  static size_t MaxCacheMemory();
+
+  /**
+   * Returns the memory limit of all FrameCaches in bytes, zero means unlimited.
+   */
+  static size_t MaxTotalMemory();
+
+  /**
+   * Returns the estimated memory used by all FrameCaches in bytes.
+   */
+  static size_t TotalMemory();
+
+  static void SetMaxCacheMemory(size_t bytes);
+
+  static void SetMaxTotalMemory(size_t bytes);
+
+  /**
+   * Returns true if any of the budgets is set.
+   */
+  static bool Enabled();
+
+  static void Allocate(size_t bytes);
+
+  static void Release(size_t bytes);
+};
+
+/**
+ * FrameCachePins keeps the frames returned by FrameCache::getCache() on the calling thread alive
+ * until the outermost FrameCachePins of that thread goes out of scope. The frames are returned as
+ * raw pointers, pinning them prevents an eviction triggered by another thread from releasing a
+ * frame that is still being rendered. Every frame is pinned at most once, so the pins never exceed
+ * the frames used by one render. Every public entry point that reads frame caches, such as
+ * rendering, measuring bounds or hit testing, must open a FrameCachePins while budgets may be set.
+ * Frames returned outside any FrameCachePins are not pinned, only the two most recent frames of
+ * each cache are kept alive for them.
+ */
+class FrameCachePins {
+ public:
+  FrameCachePins();
+
+  ~FrameCachePins();
+
+  /**
+   * Pins the cache if a FrameCachePins is alive on the calling thread.
+   */
+  static void Pin(std::shared_ptr<void> cache);
+
+  /**
+   * Returns the number of caches pinned on the calling thread.
+   */
+  static size_t PinnedCount();
+};
+
 template <typename T>
 class FrameCache : public Cache {
  public:
@@ -35,9 +101,7 @@ class FrameCache : public Cache {
   }
 
   ~FrameCache() override {
-    for (auto& item : frames) {
-      delete item.second;
-    }
+    FrameCacheBudget::Release(totalMemory);
   }
 
   virtual T* getCache(Frame contentFrame) {
@@ -48,19 +112,55 @@ class FrameCache : public Cache {
     if (contentFrame < 0) {
       contentFrame = 0;
     }
-    std::lock_guard<std::mutex> autoLock(locker);
-    auto cache = frames[contentFrame];
-    if (cache == nullptr) {
-      cache = createCache(contentFrame + startTime);
-      frames[contentFrame] = cache;
+    auto budgetEnabled = FrameCacheBudget::Enabled();
+    if (!budgetEnabled) {
+      // Nothing is evicted without budgets, so renders sharing the same file can look up frames
+      // concurrently and the access order does not need to be updated.
+      std::shared_lock<std::shared_mutex> autoLock(locker);
+      auto result = frames.find(contentFrame);
+      if (result != frames.end()) {
+        return result->second.cache.get();
+      }
+    } else {
+      std::lock_guard<std::shared_mutex> autoLock(locker);
+      auto result = frames.find(contentFrame);
+      if (result != frames.end()) {
+        return touch(&result->second);
+      }
+    }
+    // Creates the cache outside the lock, so that threads rendering different frames of the same
+    // layer do not wait for each other. If two threads create the same frame at once, the first one
+    // to finish wins.
+    auto cache = std::shared_ptr<T>(createCache(contentFrame + startTime));
+    std::lock_guard<std::shared_mutex> autoLock(locker);
+    auto result = frames.find(contentFrame);
+    if (result != frames.end()) {
+      return touch(&result->second);
     }
-    return cache;
+    auto memory = measureMemory(cache.get());
+    accessOrder.push_front(contentFrame);
+    frames[contentFrame] = {cache, memory, accessOrder.begin()};
+    totalMemory += memory;
+    FrameCacheBudget::Allocate(memory);
+    if (budgetEnabled) {
+      FrameCachePins::Pin(cache);
+      purgeIfNeeded();
+    }
+    return cache.get();
   }
 
   const std::vector<TimeRange>* getStaticTimeRanges() const {
     return &staticTimeRanges;
   }
 
+  /**
+   * Returns the estimated memory used by the cached frames in bytes.
+   */
+  size_t memoryUsage() {
+    std::shared_lock<std::shared_mutex> autoLock(locker);
+    return totalMemory;
+  }
+
  protected:
   Frame startTime = 0;
   Frame duration = 1;
@@ -68,8 +168,53 @@ class FrameCache : public Cache {
 
   virtual T* createCache(Frame layerFrame) = 0;
 
+  /**
+   * Returns the estimated memory retained by the specified cache in bytes.
+   */
+  virtual size_t measureMemory(T*) const {
+    return sizeof(T);
+  }
+
  private:
-  std::mutex locker = {};
-  std::unordered_map<Frame, T*> frames;
+  // The most recent frames are always kept, motion blur needs the transforms of the current frame
+  // and the previous one.
+  static constexpr size_t MinRetainedFrames = 2;
+
+  struct Entry {
+    std::shared_ptr<T> cache = nullptr;
+    size_t memory = 0;
+    std::list<Frame>::iterator position;
+  };
+
+  std::shared_mutex locker = {};
+  std::unordered_map<Frame, Entry> frames;
+  std::list<Frame> accessOrder;
+  size_t totalMemory = 0;
+
+  T* touch(Entry* entry) {
+    accessOrder.splice(accessOrder.begin(), accessOrder, entry->position);
+    if (FrameCacheBudget::Enabled()) {
+      FrameCachePins::Pin(entry->cache);
+    }
+    return entry->cache.get();
+  }
+
+  void purgeIfNeeded() {
+    auto maxCacheMemory = FrameCacheBudget::MaxCacheMemory();
+    auto maxTotalMemory = FrameCacheBudget::MaxTotalMemory();
+    while (accessOrder.size() > MinRetainedFrames) {
+      auto overCache = maxCacheMemory > 0 && totalMemory > maxCacheMemory;
+      auto overTotal = maxTotalMemory > 0 && FrameCacheBudget::TotalMemory() > maxTotalMemory;
+      if (!overCache && !overTotal) {
+        break;
+      }
+      auto frame = accessOrder.back();
+      accessOrder.pop_back();
+      auto result = frames.find(frame);
+      totalMemory -= result->second.memory;
+      FrameCacheBudget::Release(result->second.memory);
+      frames.erase(result);
+    }
+  }
 };
 }  // namespace pag
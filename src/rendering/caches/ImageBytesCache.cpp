@@ -21,9 +21,14 @@
 namespace pag {
 
 ImageBytesCache* ImageBytesCache::Get(ImageBytes* imageBytes) {
+  auto imageCache = imageBytes->cache.load(std::memory_order_acquire);
+  if (imageCache != nullptr) {
+    return static_cast<ImageBytesCache*>(imageCache);
+  }
   std::lock_guard<std::mutex> autoLock(imageBytes->locker);
-  if (imageBytes->cache != nullptr) {
-    return static_cast<ImageBytesCache*>(imageBytes->cache);
+  imageCache = imageBytes->cache.load(std::memory_order_relaxed);
+  if (imageCache != nullptr) {
+    return static_cast<ImageBytesCache*>(imageCache);
   }
   auto cache = new ImageBytesCache();
   auto fileBytes =
@@ -34,7 +39,7 @@ ImageBytesCache* ImageBytesCache::Get(ImageBytes* imageBytes) {
   matrix.postTranslate(static_cast<float>(-imageBytes->anchorX),
                        static_cast<float>(-imageBytes->anchorY));
   cache->graphic = Graphic::MakeCompose(picture, matrix);
-  imageBytes->cache = cache;
+  imageBytes->cache.store(cache, std::memory_order_release);
   return cache;
 }
 }  // namespace pag
\ No newline at end of file
@@ -27,11 +27,19 @@
 namespace pag {
 
 LayerCache* LayerCache::Get(Layer* layer) {
+  // The cache is created only once and lives as long as the layer, so only the first call needs to
+  // take the lock. Renders sharing the same file read it concurrently without contention.
+  auto cache = layer->cache.load(std::memory_order_acquire);
+  if (cache != nullptr) {
+    return static_cast<LayerCache*>(cache);
+  }
   std::lock_guard<std::mutex> autoLock(layer->locker);
-  if (layer->cache == nullptr) {
-    layer->cache = new LayerCache(layer);
+  cache = layer->cache.load(std::memory_order_relaxed);
+  if (cache == nullptr) {
+    cache = new LayerCache(layer);
+    layer->cache.store(cache, std::memory_order_release);
   }
-  return static_cast<LayerCache*>(layer->cache);
+  return static_cast<LayerCache*>(cache);
 }
 
 LayerCache::LayerCache(Layer* layer) : layer(layer) {
@@ -71,6 +79,7 @@ LayerCache::LayerCache(Layer* layer) : layer(layer) {
     maskCache = new MaskCache(layer);
   }
   updateStaticTimeRanges();
+  updateChangeFrameRanges();
   auto temp = layer->getScaleFactor();
   scaleFactor = {ToTGFX(temp.first), ToTGFX(temp.second)};
 }
@@ -106,6 +115,17 @@ Content* LayerCache::getContent(Frame contentFrame) {
   return contentCache->getCache(contentFrame);
 }
 
+size_t LayerCache::memoryUsage() const {
+  auto memory = transformCache->memoryUsage() + contentCache->memoryUsage();
+  if (maskCache != nullptr) {
+    memory += maskCache->memoryUsage();
+  }
+  if (featherMaskCache != nullptr) {
+    memory += featherMaskCache->memoryUsage();
+  }
+  return memory;
+}
+
 Layer* LayerCache::getLayer() const {
   return layer;
 }
@@ -177,6 +197,38 @@ void LayerCache::updateStaticTimeRanges() {
   }
 }
 
+static void AppendFrameRange(std::vector<TimeRange>* timeRanges, Frame start, Frame end) {
+  if (!timeRanges->empty() && timeRanges->back().end + 1 >= start) {
+    timeRanges->back().end = std::max(timeRanges->back().end, end);
+    return;
+  }
+  timeRanges->push_back({start, end});
+}
+
+void LayerCache::updateChangeFrameRanges() {
+  // Every frame outside a static time range differs from its previous frame, while a static time
+  // range only differs at its first frame. The frames out of [0, duration) are all treated alike.
+  changeFrameRanges.clear();
+  auto duration = layer->duration;
+  Frame frame = 0;
+  for (auto& timeRange : staticTimeRanges) {
+    auto start = std::max(timeRange.start, frame);
+    auto end = std::min(timeRange.end, duration - 1);
+    if (start > end) {
+      continue;
+    }
+    if (frame < start) {
+      AppendFrameRange(&changeFrameRanges, frame, start - 1);
+    }
+    AppendFrameRange(&changeFrameRanges, start, start);
+    frame = end + 1;
+  }
+  if (frame < duration) {
+    AppendFrameRange(&changeFrameRanges, frame, duration - 1);
+  }
+  AppendFrameRange(&changeFrameRanges, duration, duration);
+}
+
 std::vector<TimeRange> LayerCache::getTrackMatteStaticTimeRanges() {
   auto trackMatteLayer = layer->trackMatteLayer;
   std::vector<TimeRange> timeRanges = {trackMatteLayer->visibleRange()};
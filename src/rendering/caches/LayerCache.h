@@ -39,6 +39,11 @@ class LayerCache : public Cache {
 
   Content* getContent(Frame contentFrame);
 
+  /**
+   * Returns the estimated memory used by the frame caches of this layer in bytes.
+   */
+  size_t memoryUsage() const;
+
   Layer* getLayer() const;
 
   std::pair<tgfx::Point, tgfx::Point> getScaleFactor() const;
@@ -47,6 +52,15 @@ class LayerCache : public Cache {
 
   bool contentVisible(Frame contentFrame);
 
+  /**
+   * Returns the content frames at which checkFrameChanged() reports a change when stepping onto
+   * them from the previous frame, as sorted and disjoint ranges. The frames before 0 and after the
+   * layer duration count as one frame each.
+   */
+  const std::vector<TimeRange>* getChangeFrameRanges() const {
+    return &changeFrameRanges;
+  }
+
   bool contentStatic() const {
     return contentCache->contentStatic();
   }
@@ -71,8 +85,10 @@ class LayerCache : public Cache {
   ContentCache* contentCache = nullptr;
   std::pair<tgfx::Point, tgfx::Point> scaleFactor = {};
   std::vector<TimeRange> staticTimeRanges;
+  std::vector<TimeRange> changeFrameRanges;
   explicit LayerCache(Layer* layer);
   void updateStaticTimeRanges();
+  void updateChangeFrameRanges();
   std::vector<TimeRange> getTrackMatteStaticTimeRanges();
   std::vector<TimeRange> getFilterStaticTimeRanges();
 };
@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PathCache.h"
+#include <functional>
+
+namespace pag {
+bool PathKey::operator==(const PathKey& other) const {
+  return parameters == other.parameters && paths == other.paths;
+}
+
+size_t PathKeyHasher::operator()(const PathKey& key) const {
+  PathHasher pathHasher = {};
+  std::hash<float> floatHasher = {};
+  size_t hash = key.paths.size();
+  for (auto& path : key.paths) {
+    hash = hash * 31 + pathHasher(path);
+  }
+  for (auto value : key.parameters) {
+    hash = hash * 31 + floatHasher(value);
+  }
+  return hash;
+}
+
+PathCache::PathCache(size_t maxCount) : maxCount(maxCount) {
+}
+
+bool PathCache::find(const PathKey& key, std::vector<tgfx::Path>* results) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = entryMap.find(key);
+  if (result == entryMap.end()) {
+    return false;
+  }
+  entries.splice(entries.begin(), entries, result->second);
+  *results = result->second->second;
+  return true;
+}
+
+void PathCache::add(const PathKey& key, const std::vector<tgfx::Path>& results) {
+  if (maxCount == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(locker);
+  auto result = entryMap.find(key);
+  if (result != entryMap.end()) {
+    entries.splice(entries.begin(), entries, result->second);
+    result->second->second = results;
+    return;
+  }
+  entries.emplace_front(key, results);
+  entryMap[key] = entries.begin();
+  if (entries.size() > maxCount) {
+    entryMap.erase(entries.back().first);
+    entries.pop_back();
+  }
+}
+}  // namespace pag
@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "rendering/utils/PathHasher.h"
+#include "tgfx/core/Path.h"
+
+namespace pag {
+/**
+ * Identifies a path operation by the content of its input paths and its parameters.
+ */
+struct PathKey {
+  std::vector<tgfx::Path> paths = {};
+  std::vector<float> parameters = {};
+
+  bool operator==(const PathKey& other) const;
+};
+
+struct PathKeyHasher {
+  size_t operator()(const PathKey& key) const;
+};
+
+/**
+ * PathCache keeps the results of expensive path operations, such as stroking, dashing, trimming
+ * and merging. Animations that repeat or hold their geometry across frames can reuse the results
+ * instead of computing them again. It is thread-safe.
+ */
+class PathCache {
+ public:
+  explicit PathCache(size_t maxCount = 64);
+
+  /**
+   * Copies the cached result paths of the specified key to the results and returns true if found.
+   */
+  bool find(const PathKey& key, std::vector<tgfx::Path>* results);
+
+  /**
+   * Caches the result paths of the specified key, evicting the least recently used entry if the
+   * cache is full.
+   */
+  void add(const PathKey& key, const std::vector<tgfx::Path>& results);
+
+ private:
+  using Entry = std::pair<PathKey, std::vector<tgfx::Path>>;
+
+  std::mutex locker = {};
+  size_t maxCount = 0;
+  std::list<Entry> entries = {};
+  std::unordered_map<PathKey, std::list<Entry>::iterator, PathKeyHasher> entryMap = {};
+};
+}  // namespace pag
@@ -17,6 +17,8 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "RenderCache.h"
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include "base/utils/TimeUtil.h"
 #include "base/utils/UniqueID.h"
@@ -30,15 +32,48 @@
 #include "tgfx/utils/Clock.h"
 
 namespace pag {
-// 300M设置的大一些用于兜底，通常在大于20M时就开始随时清理。
-static constexpr int MAX_GRAPHICS_MEMORY = 314572800;
-static constexpr int PURGEABLE_GRAPHICS_MEMORY = 20971520;  // 20M
 static constexpr int PURGEABLE_EXPIRED_FRAME = 10;
 static constexpr float SCALE_FACTOR_PRECISION = 0.001f;
 static constexpr float MIPMAP_ENABLED_THRESHOLD = -1.0f;      // 临时关闭 mipmap
 static constexpr int64_t DECODING_VISIBLE_DISTANCE = 500000;  // 提前 500ms 开始解码。
 
-RenderCache::RenderCache(PAGStage* stage) : _uniqueID(UniqueID::Next()), stage(stage) {
+// 默认硬上限设置的大一些用于兜底，通常在超过软上限（20M）时就开始随时清理。
+static std::atomic<size_t> defaultSoftLimit = {20971520};   // 20M
+static std::atomic<size_t> defaultHardLimit = {314572800};  // 300M
+static std::atomic<size_t> maxTotalGraphicsMemory = {0};
+static std::atomic<size_t> totalGraphicsMemory = {0};
+
+size_t PAGGraphicsMemory::DefaultSoftLimit() {
+  return defaultSoftLimit;
+}
+
+void PAGGraphicsMemory::SetDefaultSoftLimit(size_t bytes) {
+  defaultSoftLimit = bytes;
+}
+
+size_t PAGGraphicsMemory::DefaultHardLimit() {
+  return defaultHardLimit;
+}
+
+void PAGGraphicsMemory::SetDefaultHardLimit(size_t bytes) {
+  defaultHardLimit = bytes;
+}
+
+size_t PAGGraphicsMemory::MaxTotalMemory() {
+  return maxTotalGraphicsMemory;
+}
+
+void PAGGraphicsMemory::SetMaxTotalMemory(size_t bytes) {
+  maxTotalGraphicsMemory = bytes;
+}
+
+size_t PAGGraphicsMemory::TotalMemory() {
+  return totalGraphicsMemory;
+}
+
+RenderCache::RenderCache(PAGStage* stage)
+    : _uniqueID(UniqueID::Next()), stage(stage), _softMemoryLimit(defaultSoftLimit),
+      _hardMemoryLimit(defaultHardLimit) {
 }
 
 RenderCache::~RenderCache() {
@@ -169,7 +204,7 @@ void RenderCache::attachToContext(tgfx::Context* current, bool forDrawing) {
     releaseAll();
   }
   context = current;
-  context->setCacheLimit(MAX_GRAPHICS_MEMORY);
+  context->setCacheLimit(_hardMemoryLimit);
   deviceID = context->device()->uniqueID();
   isDrawingFrame = forDrawing;
   if (!isDrawingFrame) {
@@ -189,7 +224,7 @@ void RenderCache::attachToContext(tgfx::Context* current, bool forDrawing) {
 void RenderCache::releaseAll() {
   clearAllSnapshots();
   clearAllTextAtlas();
-  graphicsMemory = 0;
+  decreaseGraphicsMemory(graphicsMemory);
   clearAllSequenceCaches();
   for (auto& item : filterCaches) {
     delete item.second;
@@ -216,12 +251,13 @@ void RenderCache::detachFromContext() {
     // Always purge recycled resources that haven't been used in 1 frame.
     context->purgeResourcesNotUsedSince(timestamps.back(), true);
   }
-  if (context->memoryUsage() + graphicsMemory > PURGEABLE_GRAPHICS_MEMORY &&
+  if (context->memoryUsage() + graphicsMemory > _softMemoryLimit &&
       timestamps.size() == PURGEABLE_EXPIRED_FRAME) {
     // Purge all types of resources that haven't been used in 10 frames when the total memory usage
-    // is over 20M.
+    // is over the soft limit.
     context->purgeResourcesNotUsedSince(timestamps.front(), false);
   }
+  checkMemoryLimits();
   timestamps.push(std::chrono::steady_clock::now());
   while (timestamps.size() > PURGEABLE_EXPIRED_FRAME) {
     timestamps.pop();
@@ -229,6 +265,108 @@ void RenderCache::detachFromContext() {
   context = nullptr;
 }
 
+void RenderCache::setHardMemoryLimit(size_t bytes) {
+  _hardMemoryLimit = bytes;
+  if (context != nullptr) {
+    context->setCacheLimit(_hardMemoryLimit);
+  }
+}
+
+void RenderCache::increaseGraphicsMemory(size_t bytes) {
+  graphicsMemory += bytes;
+  totalGraphicsMemory += bytes;
+}
+
+void RenderCache::decreaseGraphicsMemory(size_t bytes) {
+  graphicsMemory -= bytes;
+  totalGraphicsMemory -= bytes;
+}
+
+bool RenderCache::reachedMemoryLimit() const {
+  if (graphicsMemory >= _hardMemoryLimit) {
+    return true;
+  }
+  size_t maxTotalMemory = maxTotalGraphicsMemory;
+  return maxTotalMemory > 0 && totalGraphicsMemory >= maxTotalMemory;
+}
+
+void RenderCache::checkMemoryLimits() {
+  size_t excessMemory = 0;
+  auto memoryUsage = context->memoryUsage() + graphicsMemory;
+  if (memoryUsage > _hardMemoryLimit) {
+    excessMemory = memoryUsage - _hardMemoryLimit;
+  }
+  size_t maxTotalMemory = maxTotalGraphicsMemory;
+  size_t totalMemory = totalGraphicsMemory;
+  if (maxTotalMemory > 0 && totalMemory > maxTotalMemory) {
+    excessMemory = std::max(excessMemory, totalMemory - maxTotalMemory);
+  }
+  if (excessMemory > 0) {
+    purge(excessMemory);
+  }
+  _memoryPressure = context->memoryUsage() + graphicsMemory > _softMemoryLimit;
+}
+
+size_t RenderCache::purge(size_t bytes) {
+  // The decoded images are prepared for the upcoming frames, they are always cheap to drop.
+  decodedAssetImages.clear();
+  // Purges the unused snapshots first, then the text atlases, and finally the snapshots in use,
+  // which will be recreated in the next frame.
+  auto releasedMemory = purgeSnapshots(bytes, true);
+  if (releasedMemory < bytes) {
+    releasedMemory += purgeTextAtlases(bytes - releasedMemory);
+  }
+  if (releasedMemory < bytes) {
+    releasedMemory += purgeSnapshots(bytes - releasedMemory, false);
+  }
+  if (releasedMemory < bytes) {
+    clearExpiredSequences();
+    if (context != nullptr) {
+      auto contextMemory = context->memoryUsage();
+      auto remainingBytes = bytes - releasedMemory;
+      context->purgeResourcesUntilMemoryTo(
+          contextMemory > remainingBytes ? contextMemory - remainingBytes : 0);
+      auto purgedMemory = contextMemory - std::min(contextMemory, context->memoryUsage());
+      releasedMemory += purgedMemory;
+    }
+  }
+  return releasedMemory;
+}
+
+size_t RenderCache::purgeSnapshots(size_t bytes, bool unusedOnly) {
+  std::vector<ID> purgedAssets = {};
+  size_t releasedMemory = 0;
+  for (auto snapshotIter = snapshotLRU.rbegin();
+       snapshotIter != snapshotLRU.rend() && releasedMemory < bytes; snapshotIter++) {
+    auto* snapshot = *snapshotIter;
+    if (unusedOnly && usedAssets.count(snapshot->assetID) > 0) {
+      break;
+    }
+    releasedMemory += snapshot->memoryUsage();
+    purgedAssets.push_back(snapshot->assetID);
+  }
+  for (auto assetID : purgedAssets) {
+    removeSnapshot(assetID);
+  }
+  return releasedMemory;
+}
+
+size_t RenderCache::purgeTextAtlases(size_t bytes) {
+  std::vector<ID> purgedAssets = {};
+  size_t releasedMemory = 0;
+  for (auto& item : textAtlases) {
+    if (releasedMemory >= bytes) {
+      break;
+    }
+    releasedMemory += item.second->memoryUsage();
+    purgedAssets.push_back(item.first);
+  }
+  for (auto assetID : purgedAssets) {
+    removeTextAtlas(assetID);
+  }
+  return releasedMemory;
+}
+
 Snapshot* RenderCache::getSnapshot(ID assetID) const {
   if (!_snapshotEnabled) {
     return nullptr;
@@ -258,7 +396,7 @@ Snapshot* RenderCache::getSnapshot(const Picture* picture) {
     return snapshot;
   }
 
-  if (scaleFactor < SCALE_FACTOR_PRECISION || graphicsMemory >= MAX_GRAPHICS_MEMORY) {
+  if (scaleFactor < SCALE_FACTOR_PRECISION || reachedMemoryLimit()) {
     return nullptr;
   }
   auto minScaleFactor = stage->getAssetMinScale(picture->assetID);
@@ -270,7 +408,7 @@ Snapshot* RenderCache::getSnapshot(const Picture* picture) {
   snapshot = newSnapshot.release();
   snapshot->assetID = picture->assetID;
   snapshot->makerKey = picture->uniqueKey;
-  graphicsMemory += snapshot->memoryUsage();
+  increaseGraphicsMemory(snapshot->memoryUsage());
   snapshotLRU.push_front(snapshot);
   snapshotPositions[snapshot] = snapshotLRU.begin();
   snapshotCaches[picture->assetID] = snapshot;
@@ -283,7 +421,7 @@ void RenderCache::removeSnapshot(ID assetID) {
     return;
   }
   removeSnapshotFromLRU(snapshot->second);
-  graphicsMemory -= snapshot->second->memoryUsage();
+  decreaseGraphicsMemory(snapshot->second->memoryUsage());
   delete snapshot->second;
   snapshotCaches.erase(assetID);
 }
@@ -326,7 +464,7 @@ TextAtlas* RenderCache::getTextAtlas(const TextBlock* textBlock) {
   }
   textAtlas = TextAtlas::Make(textBlock, this, maxScaleFactor).release();
   if (textAtlas) {
-    graphicsMemory += textAtlas->memoryUsage();
+    increaseGraphicsMemory(textAtlas->memoryUsage());
     textAtlases[textBlock->assetID()] = textAtlas;
   }
   return textAtlas;
@@ -337,14 +475,14 @@ void RenderCache::removeTextAtlas(ID assetID) {
   if (textAtlas == textAtlases.end()) {
     return;
   }
-  graphicsMemory -= textAtlas->second->memoryUsage();
+  decreaseGraphicsMemory(textAtlas->second->memoryUsage());
   delete textAtlas->second;
   textAtlases.erase(textAtlas);
 }
 
 void RenderCache::clearAllTextAtlas() {
   for (auto atlas : textAtlases) {
-    graphicsMemory -= atlas.second->memoryUsage();
+    decreaseGraphicsMemory(atlas.second->memoryUsage());
     delete atlas.second;
   }
   textAtlases.clear();
@@ -352,7 +490,7 @@ void RenderCache::clearAllTextAtlas() {
 
 void RenderCache::clearAllSnapshots() {
   for (auto& item : snapshotCaches) {
-    graphicsMemory -= item.second->memoryUsage();
+    decreaseGraphicsMemory(item.second->memoryUsage());
     delete item.second;
   }
   snapshotCaches.clear();
@@ -373,8 +511,8 @@ void RenderCache::clearExpiredSnapshots() {
     }
     snapshot->idleFrames++;
     if (snapshot->idleFrames < PURGEABLE_EXPIRED_FRAME &&
-        graphicsMemory - releaseMemory < PURGEABLE_GRAPHICS_MEMORY) {
-      // 总显存占用未超过20M且所有缓存均未超过10帧未使用，跳过清理。
+        graphicsMemory - releaseMemory < _softMemoryLimit) {
+      // 总显存占用未超过软上限且所有缓存均未超过10帧未使用，跳过清理。
       continue;
     }
     releaseMemory += snapshot->memoryUsage();
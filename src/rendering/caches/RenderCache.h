@@ -64,6 +64,43 @@ class RenderCache : public Performance {
     return graphicsMemory;
   }
 
+  /**
+   * Returns the memory limit above which the caches unused in recent frames are purged at the end
+   * of every frame.
+   */
+  size_t softMemoryLimit() const {
+    return _softMemoryLimit;
+  }
+
+  void setSoftMemoryLimit(size_t bytes) {
+    _softMemoryLimit = bytes;
+  }
+
+  /**
+   * Returns the memory limit that this cache never keeps above at the end of a frame. No new
+   * snapshots are created once it is reached.
+   */
+  size_t hardMemoryLimit() const {
+    return _hardMemoryLimit;
+  }
+
+  void setHardMemoryLimit(size_t bytes);
+
+  /**
+   * Returns true if the memory usage was still over the soft limit at the end of the last frame,
+   * after purging the caches down to the hard limit and the process-wide limit.
+   */
+  bool memoryPressure() const {
+    return _memoryPressure;
+  }
+
+  /**
+   * Purges the caches until the specified number of bytes is released or nothing else can be
+   * purged. The caches unused in the last frame are purged first. Returns the released bytes.
+   * Must be called while attached to a context, since most of the caches hold GPU resources.
+   */
+  size_t purge(size_t bytes);
+
   /**
    * Returns the GPU context associated with this cache.
    */
@@ -181,6 +218,9 @@ class RenderCache : public Performance {
   std::queue<std::chrono::steady_clock::time_point> timestamps = {};
   bool isDrawingFrame = false;
   size_t graphicsMemory = 0;
+  size_t _softMemoryLimit = 0;
+  size_t _hardMemoryLimit = 0;
+  bool _memoryPressure = false;
   bool _videoEnabled = true;
   bool _snapshotEnabled = true;
   bool _useDiskCache = false;
@@ -197,6 +237,14 @@ class RenderCache : public Performance {
   MotionBlurFilter* motionBlurFilter = nullptr;
   Filter* transform3DFilter = nullptr;
 
+  // memory budget:
+  void increaseGraphicsMemory(size_t bytes);
+  void decreaseGraphicsMemory(size_t bytes);
+  bool reachedMemoryLimit() const;
+  void checkMemoryLimits();
+  size_t purgeSnapshots(size_t bytes, bool unusedOnly);
+  size_t purgeTextAtlases(size_t bytes);
+
   // decoded image caches:
   void clearExpiredDecodedImages();
 
@@ -24,9 +24,17 @@
 #include "rendering/utils/Directory.h"
 #include "tgfx/utils/Buffer.h"
 #include "tgfx/utils/DataView.h"
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+#include <sys/mman.h>
+#endif
 
 namespace pag {
-static constexpr uint8_t FILE_VERSION = 1;
+/**
+ * Version 2 adds the keyframe interval to the file head and the reference index to the frame head.
+ * Files of version 1 are still readable and keep being written in version 1.
+ */
+static constexpr uint8_t FILE_VERSION = 2;
+static constexpr uint8_t FILE_VERSION_1 = 1;
 /**
  * [version: uint8_t]
  * [compression: uint8_t]
@@ -38,8 +46,10 @@ static constexpr uint8_t FILE_VERSION = 1;
  * [frameCount: uint32_t]
  * [frameRate: uint32_t]
  * [staticTimeRangeCount: uint32_t]
+ * [keyframeInterval: uint32_t] (since version 2)
  */
-static constexpr uint32_t FILE_HEAD_SIZE = 28;
+static constexpr uint32_t FILE_HEAD_SIZE_V1 = 28;
+static constexpr uint32_t FILE_HEAD_SIZE = 32;
 /**
  * [start: uint32_t]
  * [end: uint32_t]
@@ -48,31 +58,112 @@ static constexpr uint32_t TIME_RANGE_SIZE = 8;
 /**
  * [frameIndex: uint32_t]
  * [frameSize: uint64_t]
+ * [referenceIndex: uint32_t] (since version 2, equals to frameIndex for keyframes)
+ */
+static constexpr uint32_t FRAME_HEAD_SIZE_V1 = 12;
+static constexpr uint32_t FRAME_HEAD_SIZE = 16;
+
+/**
+ * FileMapping maps the written part of a sequence file into memory as read-only. The mapping is
+ * never resized, a new one is created when frames beyond its end are requested, while the old one
+ * is released after all the readers are finished.
  */
-static constexpr uint32_t FRAME_HEAD_SIZE = 12;
+class FileMapping {
+ public:
+  static std::shared_ptr<FileMapping> Make(FILE* file, size_t length) {
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+    if (file == nullptr || length == 0) {
+      return nullptr;
+    }
+    auto address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fileno(file), 0);
+    if (address == MAP_FAILED) {
+      return nullptr;
+    }
+    return std::shared_ptr<FileMapping>(
+        new FileMapping(static_cast<const uint8_t*>(address), length));
+#else
+    return nullptr;
+#endif
+  }
+
+  ~FileMapping() {
+#if !defined(_WIN32) && !defined(PAG_BUILD_FOR_WEB)
+    munmap(const_cast<uint8_t*>(_bytes), _size);
+#endif
+  }
+
+  const uint8_t* bytes() const {
+    return _bytes;
+  }
+
+  size_t size() const {
+    return _size;
+  }
+
+ private:
+  const uint8_t* _bytes = nullptr;
+  size_t _size = 0;
+
+  FileMapping(const uint8_t* bytes, size_t size) : _bytes(bytes), _size(size) {
+  }
+};
+
+static FrameCodec* GetDecoder(CompressionType type) {
+  // Codecs hold compression contexts, which can not be shared by threads.
+  static thread_local std::unique_ptr<FrameCodec> decoders[3] = {};
+  auto index = static_cast<int>(type) - 1;
+  if (index < 0 || index >= 3) {
+    return nullptr;
+  }
+  auto& decoder = decoders[index];
+  if (decoder == nullptr) {
+    decoder = FrameCodec::Make(type);
+  }
+  return decoder.get();
+}
+
+static void XORPixels(uint8_t* dstPixels, const uint8_t* srcPixels, size_t byteSize) {
+  size_t index = 0;
+  for (; index + sizeof(uint64_t) <= byteSize; index += sizeof(uint64_t)) {
+    uint64_t dst = 0;
+    uint64_t src = 0;
+    memcpy(&dst, dstPixels + index, sizeof(uint64_t));
+    memcpy(&src, srcPixels + index, sizeof(uint64_t));
+    dst ^= src;
+    memcpy(dstPixels + index, &dst, sizeof(uint64_t));
+  }
+  for (; index < byteSize; index++) {
+    dstPixels[index] ^= srcPixels[index];
+  }
+}
 
 std::shared_ptr<SequenceFile> SequenceFile::Open(const std::string& filePath,
                                                  const tgfx::ImageInfo& info, int frameCount,
                                                  float frameRate,
-                                                 const std::vector<TimeRange>& staticTimeRanges) {
+                                                 const std::vector<TimeRange>& staticTimeRanges,
+                                                 CompressionType compressionType,
+                                                 int keyframeInterval) {
   if (filePath.empty() || info.isEmpty() || frameCount == 0 || frameRate <= 0) {
     return nullptr;
   }
   auto sequenceFile = std::shared_ptr<SequenceFile>(
-      new SequenceFile(filePath, info, frameCount, frameRate, staticTimeRanges));
+      new SequenceFile(filePath, info, frameCount, frameRate, staticTimeRanges, compressionType,
+                       keyframeInterval));
   return sequenceFile->file ? sequenceFile : nullptr;
 }
 
 SequenceFile::SequenceFile(const std::string& filePath, const tgfx::ImageInfo& info, int frameCount,
-                           float frameRate, std::vector<TimeRange> staticTimeRanges)
-    : _info(info), _numFrames(frameCount), _frameRate(frameRate),
+                           float frameRate, std::vector<TimeRange> staticTimeRanges,
+                           CompressionType compressionType, int keyframeInterval)
+    : fileVersion(FILE_VERSION), compressionType(compressionType),
+      keyframeInterval(keyframeInterval > 1 ? keyframeInterval : 0), _info(info),
+      _numFrames(frameCount), _frameRate(frameRate),
       _staticTimeRanges(std::move(staticTimeRanges)) {
-  decoder = LZ4Decoder::Make();
   Directory::CreateRecursively(Directory::GetParentDirectory(filePath));
-#ifdef __APPLE__
-  compressionType = CompressionType::LZ4_APPLE;
-#endif
-  frames.resize(frameCount, {0, 0});
+  if (GetDecoder(this->compressionType) == nullptr) {
+    this->compressionType = FrameCodec::DefaultType();
+  }
+  frames.resize(frameCount, {});
   file = fopen(filePath.c_str(), "ab+");
   if (file == nullptr) {
     return;
@@ -86,6 +177,12 @@ SequenceFile::SequenceFile(const std::string& filePath, const tgfx::ImageInfo& i
     cachedFrames = 0;
     memset(frames.data(), 0, sizeof(FrameLocation) * frames.size());
     _fileSize = 0;
+    fileVersion = FILE_VERSION;
+    this->compressionType = compressionType;
+    if (GetDecoder(this->compressionType) == nullptr) {
+      this->compressionType = FrameCodec::DefaultType();
+    }
+    this->keyframeInterval = keyframeInterval > 1 ? keyframeInterval : 0;
     fclose(file);
     file = fopen(filePath.c_str(), "wb+");
     LOGE("The existing sequence file has been reset, which may be corrupted!");
@@ -105,12 +202,12 @@ bool SequenceFile::readFramesFromFile() {
   fseek(file, 0, SEEK_SET);
   tgfx::Buffer buffer(FILE_HEAD_SIZE);
   auto data = tgfx::DataView(buffer.bytes(), buffer.size());
-  auto readLength = fread(data.writableBytes(), 1, data.size(), file);
-  if (readLength != data.size()) {
+  auto readLength = fread(data.writableBytes(), 1, FILE_HEAD_SIZE_V1, file);
+  if (readLength != FILE_HEAD_SIZE_V1) {
     return false;
   }
   auto version = data.getUint8(0);
-  auto compression = data.getUint8(1);
+  auto compression = static_cast<CompressionType>(data.getUint8(1));
   auto colorType = data.getUint8(2);
   auto alphaType = data.getUint8(3);
   auto fileWidth = data.getUint32(4);
@@ -122,11 +219,20 @@ bool SequenceFile::readFramesFromFile() {
   auto info = tgfx::ImageInfo::Make(static_cast<int>(fileWidth), static_cast<int>(fileHeight),
                                     static_cast<tgfx::ColorType>(colorType),
                                     static_cast<tgfx::AlphaType>(alphaType), rowBytes);
-  if (version != FILE_VERSION || compression != static_cast<uint8_t>(compressionType) ||
-      info != _info || fileFrameCount != static_cast<uint32_t>(_numFrames) ||
-      fileFrameRate != _frameRate || staticTimeRangeCount != _staticTimeRanges.size()) {
+  if ((version != FILE_VERSION && version != FILE_VERSION_1) ||
+      GetDecoder(compression) == nullptr || info != _info ||
+      fileFrameCount != static_cast<uint32_t>(_numFrames) || fileFrameRate != _frameRate ||
+      staticTimeRangeCount != _staticTimeRanges.size()) {
     return false;
   }
+  uint32_t fileKeyframeInterval = 0;
+  if (version == FILE_VERSION) {
+    readLength = fread(data.writableBytes(), 1, FILE_HEAD_SIZE - FILE_HEAD_SIZE_V1, file);
+    if (readLength != FILE_HEAD_SIZE - FILE_HEAD_SIZE_V1) {
+      return false;
+    }
+    fileKeyframeInterval = data.getUint32(0);
+  }
   for (uint32_t i = 0; i < staticTimeRangeCount; i++) {
     readLength = fread(data.writableBytes(), 1, TIME_RANGE_SIZE, file);
     if (readLength != TIME_RANGE_SIZE) {
@@ -137,23 +243,38 @@ bool SequenceFile::readFramesFromFile() {
       return false;
     }
   }
+  // The existing file keeps its own format, no matter what the caller requested.
+  fileVersion = version;
+  compressionType = compression;
+  keyframeInterval = static_cast<int>(fileKeyframeInterval);
+  auto headSize = frameHeadSize();
   long position = 0;
   while (true) {
-    readLength = fread(data.writableBytes(), 1, FRAME_HEAD_SIZE, file);
+    readLength = fread(data.writableBytes(), 1, headSize, file);
     if (readLength == 0) {
       break;
     }
-    if (readLength != FRAME_HEAD_SIZE) {
+    if (readLength != headSize) {
       return false;
     }
     auto frameIndex = data.getUint32(0);
     auto frameSize = data.getUint64(4);
-    if (frameIndex >= static_cast<uint32_t>(_numFrames)) {
+    auto referenceIndex = fileVersion == FILE_VERSION ? data.getUint32(12) : frameIndex;
+    if (frameIndex >= static_cast<uint32_t>(_numFrames) ||
+        referenceIndex >= static_cast<uint32_t>(_numFrames)) {
       return false;
     }
     auto& frame = frames[frameIndex];
     frame.offset = static_cast<size_t>(ftell(file));
     frame.size = frameSize;
+    if (referenceIndex != frameIndex) {
+      const auto& reference = frames[referenceIndex];
+      if (reference.size == 0 || reference.referenceSize != 0) {
+        return false;
+      }
+      frame.referenceOffset = reference.offset;
+      frame.referenceSize = reference.size;
+    }
     cachedFrames++;
     if (fseek(file, static_cast<long>(frameSize), SEEK_CUR)) {
       return false;
@@ -175,8 +296,12 @@ bool SequenceFile::readFramesFromFile() {
   return true;
 }
 
+size_t SequenceFile::frameHeadSize() const {
+  return fileVersion == FILE_VERSION_1 ? FRAME_HEAD_SIZE_V1 : FRAME_HEAD_SIZE;
+}
+
 bool SequenceFile::writeFileHead() {
-  tgfx::Buffer buffer(FILE_HEAD_SIZE + _staticTimeRanges.size() * 8);
+  tgfx::Buffer buffer(FILE_HEAD_SIZE + _staticTimeRanges.size() * TIME_RANGE_SIZE);
   auto data = tgfx::DataView(buffer.bytes(), buffer.size());
   data.setUint8(0, FILE_VERSION);
   data.setUint8(1, static_cast<uint8_t>(compressionType));
@@ -188,8 +313,9 @@ bool SequenceFile::writeFileHead() {
   data.setUint32(16, _numFrames);
   data.setFloat(20, _frameRate);
   data.setUint32(24, static_cast<uint32_t>(_staticTimeRanges.size()));
+  data.setUint32(28, static_cast<uint32_t>(keyframeInterval));
   for (size_t i = 0; i < _staticTimeRanges.size(); i++) {
-    auto offset = 28 + i * 8;
+    auto offset = FILE_HEAD_SIZE + i * TIME_RANGE_SIZE;
     data.setUint32(offset, static_cast<uint32_t>(_staticTimeRanges[i].start));
     data.setUint32(offset + 4, static_cast<uint32_t>(_staticTimeRanges[i].end));
   }
@@ -199,6 +325,7 @@ bool SequenceFile::writeFileHead() {
     LOGE("SequenceFile::writeFileHead() write file head failed!");
     return false;
   }
+  fileVersion = FILE_VERSION;
   return true;
 }
 
@@ -213,7 +340,6 @@ bool SequenceFile::isComplete() {
 }
 
 bool SequenceFile::readFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
-  std::lock_guard<std::mutex> autoLock(locker);
   if (index < 0 || index >= _numFrames || bitmap == nullptr) {
     LOGE("SequenceFile::readFrame() invalid index or pixels!");
     return false;
@@ -222,30 +348,102 @@ bool SequenceFile::readFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
     LOGE("SequenceFile::readFrame() the info of the specified bitmap is different from ours!");
     return false;
   }
-  const auto& frame = frames[index];
-  if (frame.size == 0) {
-    return false;
+  FrameLocation frame = {};
+  std::shared_ptr<FileMapping> mapping = nullptr;
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    frame = frames[index];
+    if (frame.size == 0) {
+      return false;
+    }
+    mapping = checkFileMapping(frame.offset + frame.size);
+    if (mapping == nullptr) {
+      return readFrameFromFile(frame, bitmap);
+    }
   }
-  if (!checkScratchBuffer()) {
-    return false;
+  auto bytes = mapping->bytes();
+  return decodeFrame(bytes + frame.offset, frame.size, bytes + frame.referenceOffset,
+                     frame.referenceSize, bitmap);
+}
+
+std::shared_ptr<FileMapping> SequenceFile::checkFileMapping(size_t length) {
+  if (fileMapping != nullptr && fileMapping->size() >= length) {
+    return fileMapping;
   }
-  if (fseek(file, static_cast<long>(frame.offset), SEEK_SET)) {
-    LOGE("SequenceFile::readFrame() fseek failed! (offset: %zu)", frame.offset);
-    return false;
+  if (mappingDisabled) {
+    return nullptr;
   }
-  auto encodedLength = fread(scratchBuffer.bytes(), 1, frame.size, file);
-  if (encodedLength != frame.size) {
-    LOGE("SequenceFile::readFrame() fread failed! (size: %zu)", frame.size);
+  auto mapping = FileMapping::Make(file, _fileSize);
+  if (mapping == nullptr) {
+    mappingDisabled = true;
+    return nullptr;
+  }
+  fileMapping = mapping;
+  return mapping;
+}
+
+bool SequenceFile::readFrameFromFile(const FrameLocation& frame,
+                                     std::shared_ptr<BitmapBuffer> bitmap) {
+  if (!checkScratchBuffer()) {
     return false;
   }
+  if (scratchBuffer.size() < frame.size + frame.referenceSize) {
+    tgfx::Buffer buffer(frame.size + frame.referenceSize);
+    if (buffer.isEmpty()) {
+      LOGE("SequenceFile::readFrame() failed to alloc scratch buffer!");
+      return false;
+    }
+    scratchBuffer = std::move(buffer);
+  }
+  auto frameBytes = scratchBuffer.bytes();
+  auto referenceBytes = scratchBuffer.bytes() + frame.size;
+  const std::pair<uint8_t*, const FrameLocation> locations[] = {
+      {frameBytes, {frame.offset, frame.size}},
+      {referenceBytes, {frame.referenceOffset, frame.referenceSize}}};
+  for (auto& location : locations) {
+    if (location.second.size == 0) {
+      continue;
+    }
+    if (fseek(file, static_cast<long>(location.second.offset), SEEK_SET)) {
+      LOGE("SequenceFile::readFrame() fseek failed! (offset: %zu)", location.second.offset);
+      return false;
+    }
+    auto readLength = fread(location.first, 1, location.second.size, file);
+    if (readLength != location.second.size) {
+      LOGE("SequenceFile::readFrame() fread failed! (size: %zu)", location.second.size);
+      return false;
+    }
+  }
+  return decodeFrame(frameBytes, frame.size, referenceBytes, frame.referenceSize, bitmap);
+}
+
+bool SequenceFile::decodeFrame(const uint8_t* frameBytes, size_t frameSize,
+                               const uint8_t* referenceBytes, size_t referenceSize,
+                               std::shared_ptr<BitmapBuffer> bitmap) {
+  auto decoder = GetDecoder(compressionType);
   auto byteSize = _info.byteSize();
   auto pixels = bitmap->lockPixels();
   if (pixels == nullptr) {
     LOGE("SequenceFile::readFrame() failed to lock pixels from the specified bitmap!");
     return false;
   }
-  auto decodedLength = decoder->decode(reinterpret_cast<uint8_t*>(pixels), byteSize,
-                                       scratchBuffer.bytes(), encodedLength);
+  auto dstPixels = reinterpret_cast<uint8_t*>(pixels);
+  size_t decodedLength = 0;
+  if (referenceSize == 0) {
+    decodedLength = decoder->decode(dstPixels, byteSize, frameBytes, frameSize);
+  } else {
+    static thread_local tgfx::Buffer deltaBuffer = {};
+    if (deltaBuffer.size() < byteSize) {
+      deltaBuffer.alloc(byteSize);
+    }
+    if (!deltaBuffer.isEmpty() &&
+        decoder->decode(dstPixels, byteSize, referenceBytes, referenceSize) == byteSize) {
+      decodedLength = decoder->decode(deltaBuffer.bytes(), byteSize, frameBytes, frameSize);
+      if (decodedLength == byteSize) {
+        XORPixels(dstPixels, deltaBuffer.bytes(), byteSize);
+      }
+    }
+  }
   bitmap->unlockPixels();
   if (decodedLength != byteSize) {
     LOGE("SequenceFile::readFrame() decode failed! (decoded: %zu, expected: %zu)", decodedLength,
@@ -269,36 +467,48 @@ bool SequenceFile::writeFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
   if (frames[timeRange.start].size != 0) {
     return false;
   }
+  if (_fileSize == 0 && !writeFileHead()) {
+    return false;
+  }
   auto pixels = bitmap->lockPixels();
   if (pixels == nullptr) {
     LOGE("SequenceFile::writeFrame() failed to lock pixels from the specified bitmap!");
     return false;
   }
-  auto compressedSize = compressFrame(static_cast<int>(timeRange.start), pixels, _info.byteSize());
+  auto frameIndex = static_cast<int>(timeRange.start);
+  auto referenceIndex = frameIndex;
+  auto compressedSize = compressFrame(frameIndex, pixels, _info.byteSize(), &referenceIndex);
   bitmap->unlockPixels();
   if (compressedSize == 0) {
     return false;
   }
-  if (_fileSize == 0 && !writeFileHead()) {
-    return false;
-  }
-  if (fseek(file, 0, SEEK_END)) {
-    LOGE("SequenceFile::writeFrame() failed to seek to the end of the file");
-    return false;
-  }
-  if (fwrite(scratchBuffer.bytes(), 1, compressedSize, file) != compressedSize) {
+  if (fseek(file, 0, SEEK_END) ||
+      fwrite(scratchBuffer.bytes(), 1, compressedSize, file) != compressedSize) {
     LOGE("SequenceFile::writeFrame() failed to write the compressed frame to disk");
+    if (keyframeIndex == frameIndex) {
+      keyframeIndex = -1;
+    }
     return false;
   }
+  // Flushes the frame out of the stdio buffer to make it visible to the file mappings.
+  fflush(file);
+  FrameLocation location = {};
+  location.offset = _fileSize + frameHeadSize();
+  location.size = compressedSize - frameHeadSize();
+  if (referenceIndex != frameIndex) {
+    const auto& reference = frames[referenceIndex];
+    location.referenceOffset = reference.offset;
+    location.referenceSize = reference.size;
+  }
   for (auto i = timeRange.start; i <= timeRange.end; i++) {
-    auto& frame = frames[i];
-    frame.offset = _fileSize + FRAME_HEAD_SIZE;
-    frame.size = compressedSize - FRAME_HEAD_SIZE;
+    frames[i] = location;
     cachedFrames++;
   }
   _fileSize += compressedSize;
   if (cachedFrames == _numFrames) {
     scratchBuffer.reset();
+    keyframePixels.reset();
+    deltaPixels.reset();
     encoder = nullptr;
   }
   if (diskCache) {
@@ -307,17 +517,53 @@ bool SequenceFile::writeFrame(int index, std::shared_ptr<BitmapBuffer> bitmap) {
   return true;
 }
 
-size_t SequenceFile::compressFrame(int index, const void* pixels, size_t byteSize) {
+size_t SequenceFile::compressFrame(int index, const void* pixels, size_t byteSize,
+                                   int* referenceIndex) {
   if (!checkScratchBuffer()) {
     return 0;
   }
   if (encoder == nullptr) {
-    encoder = LZ4Encoder::Make();
+    encoder = FrameCodec::Make(compressionType);
+    if (encoder == nullptr) {
+      return 0;
+    }
+  }
+  auto srcPixels = reinterpret_cast<const uint8_t*>(pixels);
+  auto headSize = frameHeadSize();
+  auto bytes = scratchBuffer.bytes() + headSize;
+  auto size = scratchBuffer.size() - headSize;
+  *referenceIndex = index;
+  size_t encodedLength = 0;
+  auto isKeyframe = keyframeInterval == 0 || fileVersion == FILE_VERSION_1 || keyframeIndex < 0 ||
+                    framesSinceKeyframe >= keyframeInterval - 1;
+  if (isKeyframe) {
+    encodedLength = encoder->encode(bytes, size, srcPixels, byteSize);
+    if (encodedLength > 0 && keyframeInterval > 0 && fileVersion != FILE_VERSION_1) {
+      if (keyframePixels.size() < byteSize) {
+        keyframePixels.alloc(byteSize);
+      }
+      if (!keyframePixels.isEmpty()) {
+        memcpy(keyframePixels.bytes(), srcPixels, byteSize);
+        keyframeIndex = index;
+        framesSinceKeyframe = 0;
+      }
+    }
+  } else {
+    // Consecutive frames mostly differ in small regions, so the XOR result is mostly zero and
+    // compresses much better than the frame itself.
+    if (deltaPixels.size() < byteSize) {
+      deltaPixels.alloc(byteSize);
+      if (deltaPixels.isEmpty()) {
+        LOGE("SequenceFile::compressFrame() failed to alloc delta buffer!");
+        return 0;
+      }
+    }
+    memcpy(deltaPixels.bytes(), srcPixels, byteSize);
+    XORPixels(deltaPixels.bytes(), keyframePixels.bytes(), byteSize);
+    encodedLength = encoder->encode(bytes, size, deltaPixels.bytes(), byteSize);
+    *referenceIndex = keyframeIndex;
+    framesSinceKeyframe++;
   }
-  auto bytes = scratchBuffer.bytes() + FRAME_HEAD_SIZE;
-  auto size = scratchBuffer.size() - FRAME_HEAD_SIZE;
-  auto encodedLength =
-      encoder->encode(bytes, size, reinterpret_cast<const uint8_t*>(pixels), byteSize);
   if (encodedLength == 0) {
     LOGE("SequenceFile::compressFrame() failed to encode frame %d!", index);
     return 0;
@@ -325,7 +571,10 @@ size_t SequenceFile::compressFrame(int index, const void* pixels, size_t byteSiz
   tgfx::DataView dataView(scratchBuffer.bytes(), scratchBuffer.size());
   dataView.setUint32(0, index);
   dataView.setUint64(4, encodedLength);
-  return encodedLength + FRAME_HEAD_SIZE;
+  if (headSize == FRAME_HEAD_SIZE) {
+    dataView.setUint32(12, static_cast<uint32_t>(*referenceIndex));
+  }
+  return encodedLength + headSize;
 }
 
 bool SequenceFile::checkScratchBuffer() {
@@ -335,12 +584,13 @@ bool SequenceFile::checkScratchBuffer() {
   size_t scratchBufferSize = 0;
   if (cachedFrames == _numFrames) {
     for (auto& frame : frames) {
-      if (frame.size > scratchBufferSize) {
-        scratchBufferSize = frame.size;
+      if (frame.size + frame.referenceSize > scratchBufferSize) {
+        scratchBufferSize = frame.size + frame.referenceSize;
       }
     }
   } else {
-    scratchBufferSize = LZ4Encoder::GetMaxOutputSize(_info.byteSize()) + FRAME_HEAD_SIZE;
+    auto codec = GetDecoder(compressionType);
+    scratchBufferSize = codec->maxEncodedSize(_info.byteSize()) + FRAME_HEAD_SIZE;
   }
   scratchBuffer.alloc(scratchBufferSize);
   if (scratchBuffer.isEmpty()) {
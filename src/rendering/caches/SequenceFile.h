@@ -23,22 +23,23 @@
 #include <vector>
 #include "pag/types.h"
 #include "rendering/utils/BitmapBuffer.h"
-#include "rendering/utils/LZ4Decoder.h"
-#include "rendering/utils/LZ4Encoder.h"
+#include "rendering/utils/FrameCodec.h"
 #include "tgfx/core/ImageInfo.h"
 #include "tgfx/utils/Buffer.h"
 
 namespace pag {
 class DiskCache;
+class FileMapping;
 
 struct FrameLocation {
   size_t offset = 0;
   size_t size = 0;
-};
-
-enum class CompressionType {
-  LZ4 = 1,
-  LZ4_APPLE = 2,
+  /**
+   * The location of the keyframe this frame is XOR-encoded against, the size is zero if the frame
+   * is a keyframe.
+   */
+  size_t referenceOffset = 0;
+  size_t referenceSize = 0;
 };
 
 /**
@@ -102,7 +103,9 @@ class SequenceFile {
 
   /**
    * Reads an image frame from the sequence into the specified pixel address. Returns false if the
-   * specified index is empty or the bitmap info is different from ours.
+   * specified index is empty or the bitmap info is different from ours. Frames are decoded directly
+   * from a read-only memory mapping of the file if possible, so multiple threads can read frames
+   * from the same sequence in parallel.
    */
   bool readFrame(int index, std::shared_ptr<BitmapBuffer> bitmap);
 
@@ -118,7 +121,9 @@ class SequenceFile {
   uint32_t fileID = 0;
   FILE* file = nullptr;
   size_t _fileSize = 0;
+  uint8_t fileVersion = 0;
   CompressionType compressionType = CompressionType::LZ4;
+  int keyframeInterval = 0;
   tgfx::ImageInfo _info = {};
   int _numFrames = 0;
   float _frameRate = 30.0f;
@@ -126,20 +131,33 @@ class SequenceFile {
   int cachedFrames = 0;
   std::vector<FrameLocation> frames = {};
   tgfx::Buffer scratchBuffer = {};
-  std::unique_ptr<LZ4Decoder> decoder = nullptr;
-  std::unique_ptr<LZ4Encoder> encoder = nullptr;
+  std::unique_ptr<FrameCodec> encoder = nullptr;
+  tgfx::Buffer keyframePixels = {};
+  tgfx::Buffer deltaPixels = {};
+  int keyframeIndex = -1;
+  int framesSinceKeyframe = 0;
+  std::shared_ptr<FileMapping> fileMapping = nullptr;
+  bool mappingDisabled = false;
 
   static std::shared_ptr<SequenceFile> Open(const std::string& filePath,
                                             const tgfx::ImageInfo& info, int frameCount,
                                             float frameRate,
-                                            const std::vector<TimeRange>& staticTimeRanges);
+                                            const std::vector<TimeRange>& staticTimeRanges,
+                                            CompressionType compressionType,
+                                            int keyframeInterval);
 
   SequenceFile(const std::string& filePath, const tgfx::ImageInfo& info, int frameCount,
-               float frameRate, std::vector<TimeRange> staticTimeRanges);
+               float frameRate, std::vector<TimeRange> staticTimeRanges,
+               CompressionType compressionType, int keyframeInterval);
 
   bool readFramesFromFile();
+  std::shared_ptr<FileMapping> checkFileMapping(size_t length);
+  bool readFrameFromFile(const FrameLocation& frame, std::shared_ptr<BitmapBuffer> bitmap);
+  bool decodeFrame(const uint8_t* frameBytes, size_t frameSize, const uint8_t* referenceBytes,
+                   size_t referenceSize, std::shared_ptr<BitmapBuffer> bitmap);
+  size_t frameHeadSize() const;
   bool writeFileHead();
-  size_t compressFrame(int index, const void* pixels, size_t byteSize);
+  size_t compressFrame(int index, const void* pixels, size_t byteSize, int* referenceIndex);
   bool checkScratchBuffer();
   bool compatible(const tgfx::ImageInfo& info, int frameCount, float frameRate,
                   const std::vector<TimeRange>& staticTimeRanges);
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "ContentCache.h"
+#include "rendering/caches/PathCache.h"
 
 namespace pag {
 class ShapeContentCache : public ContentCache {
@@ -28,5 +29,9 @@ class ShapeContentCache : public ContentCache {
  protected:
   void excludeVaryingRanges(std::vector<TimeRange>* timeRanges) const override;
   GraphicContent* createContent(Frame layerFrame) const override;
+
+ private:
+  // Shared by all frames of the layer, so that the repeated geometry is computed only once.
+  mutable PathCache pathCache;
 };
 }  // namespace pag
@@ -47,6 +47,10 @@ void Drawable::present(tgfx::Context*) {
 void Drawable::setTimeStamp(int64_t) {
 }
 
+bool Drawable::preservesContent() const {
+  return false;
+}
+
 void Drawable::onFreeSurface() {
 }
 }  // namespace pag
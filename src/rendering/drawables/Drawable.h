@@ -45,6 +45,12 @@ class Drawable {
 
   virtual void updateSize();
 
+  /**
+   * Returns true if the pixels of the surface stay unchanged after being presented, so that the
+   * next frame can redraw only the region that has changed.
+   */
+  virtual bool preservesContent() const;
+
  protected:
   std::shared_ptr<tgfx::Surface> surface = nullptr;
 
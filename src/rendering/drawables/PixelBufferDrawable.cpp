@@ -0,0 +1,94 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PixelBufferDrawable.h"
+#include "base/utils/Log.h"
+#include "tgfx/opengl/GLDevice.h"
+
+namespace pag {
+std::shared_ptr<PixelBufferDrawable> PixelBufferDrawable::Make(
+    int width, int height, const std::vector<void*>& buffers, const tgfx::ImageInfo& info,
+    std::function<void(int)> frameReady) {
+  if (width <= 0 || height <= 0 || buffers.empty() || info.isEmpty()) {
+    return nullptr;
+  }
+  for (auto buffer : buffers) {
+    if (buffer == nullptr) {
+      LOGE("PixelBufferDrawable::Make() One of the buffers is nullptr!");
+      return nullptr;
+    }
+  }
+  auto device = tgfx::GLDevice::MakeWithFallback();
+  if (device == nullptr) {
+    return nullptr;
+  }
+  return std::shared_ptr<PixelBufferDrawable>(new PixelBufferDrawable(
+      width, height, std::move(device), buffers, info, std::move(frameReady)));
+}
+
+PixelBufferDrawable::PixelBufferDrawable(int width, int height,
+                                         std::shared_ptr<tgfx::Device> device,
+                                         const std::vector<void*>& buffers,
+                                         const tgfx::ImageInfo& info,
+                                         std::function<void(int)> frameReady)
+    : _width(width), _height(height), device(std::move(device)), buffers(buffers), info(info),
+      frameReady(std::move(frameReady)), bufferInUse(buffers.size(), false) {
+}
+
+void PixelBufferDrawable::present(tgfx::Context*) {
+  if (surface == nullptr) {
+    return;
+  }
+  auto bufferIndex = nextBufferIndex;
+  {
+    // Waits for the caller to finish consuming the buffer, the frame stays in the surface until
+    // then.
+    std::unique_lock<std::mutex> autoLock(locker);
+    condition.wait(autoLock, [&] { return !bufferInUse[bufferIndex]; });
+  }
+  if (!surface->readPixels(info, buffers[bufferIndex])) {
+    LOGE("PixelBufferDrawable::present() Failed to read pixels into the buffer!");
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    bufferInUse[bufferIndex] = true;
+  }
+  nextBufferIndex = (bufferIndex + 1) % buffers.size();
+  if (frameReady) {
+    frameReady(static_cast<int>(bufferIndex));
+  } else {
+    releaseBuffer(static_cast<int>(bufferIndex));
+  }
+}
+
+void PixelBufferDrawable::releaseBuffer(int bufferIndex) {
+  if (bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= buffers.size()) {
+    return;
+  }
+  std::lock_guard<std::mutex> autoLock(locker);
+  bufferInUse[bufferIndex] = false;
+  condition.notify_all();
+}
+
+std::shared_ptr<tgfx::Surface> PixelBufferDrawable::onCreateSurface(tgfx::Context* context) {
+  auto colorType = info.colorType() == tgfx::ColorType::BGRA_8888 ? tgfx::ColorType::BGRA_8888
+                                                                   : tgfx::ColorType::RGBA_8888;
+  return tgfx::Surface::Make(context, _width, _height, colorType);
+}
+}  // namespace pag
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Drawable.h"
+#include "tgfx/core/ImageInfo.h"
+
+namespace pag {
+/**
+ * PixelBufferDrawable renders off-screen and writes every presented frame into a ring of
+ * caller-owned pixel buffers, while the GPU context is still locked for the flush. A buffer is
+ * handed to the caller through the frameReady callback and is not written again until the caller
+ * releases it.
+ */
+class PixelBufferDrawable : public Drawable {
+ public:
+  static std::shared_ptr<PixelBufferDrawable> Make(int width, int height,
+                                                   const std::vector<void*>& buffers,
+                                                   const tgfx::ImageInfo& info,
+                                                   std::function<void(int)> frameReady);
+
+  int width() const override {
+    return _width;
+  }
+
+  int height() const override {
+    return _height;
+  }
+
+  std::shared_ptr<tgfx::Device> getDevice() override {
+    return device;
+  }
+
+  bool preservesContent() const override {
+    return true;
+  }
+
+  void present(tgfx::Context* context) override;
+
+  /**
+   * Returns the buffer at the given index to the ring, so that it can be written again.
+   */
+  void releaseBuffer(int bufferIndex);
+
+ protected:
+  std::shared_ptr<tgfx::Surface> onCreateSurface(tgfx::Context* context) override;
+
+ private:
+  int _width = 0;
+  int _height = 0;
+  std::shared_ptr<tgfx::Device> device = nullptr;
+  std::vector<void*> buffers = {};
+  tgfx::ImageInfo info = {};
+  std::function<void(int)> frameReady = nullptr;
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  std::vector<bool> bufferInUse = {};
+  size_t nextBufferIndex = 0;
+
+  PixelBufferDrawable(int width, int height, std::shared_ptr<tgfx::Device> device,
+                      const std::vector<void*>& buffers, const tgfx::ImageInfo& info,
+                      std::function<void(int)> frameReady);
+};
+}  // namespace pag
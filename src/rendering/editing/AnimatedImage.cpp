@@ -0,0 +1,238 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AnimatedImage.h"
+#include <algorithm>
+#include <cctype>
+#include "base/utils/Log.h"
+#include "base/utils/TimeUtil.h"
+#include "rendering/graphics/Picture.h"
+#include "rendering/sequences/ImageSequenceReader.h"
+#include "rendering/sequences/VideoReader.h"
+#include "rendering/utils/Directory.h"
+#include "rendering/video/MP4Demuxer.h"
+
+namespace pag {
+class AnimatedImageProxy : public ImageProxy {
+ public:
+  AnimatedImageProxy(std::weak_ptr<AnimatedImage> image, int width, int height, Frame targetFrame)
+      : weakImage(std::move(image)), _width(width), _height(height), targetFrame(targetFrame) {
+  }
+
+  int width() const override {
+    return _width;
+  }
+
+  int height() const override {
+    return _height;
+  }
+
+  bool isTemporary() const override {
+    return true;
+  }
+
+  void prepareImage(RenderCache*) const override {
+    auto image = weakImage.lock();
+    if (image != nullptr) {
+      image->prepare(targetFrame);
+    }
+  }
+
+  std::shared_ptr<tgfx::Image> getImage(RenderCache* cache) const override {
+    return makeImage(cache);
+  }
+
+ protected:
+  std::shared_ptr<tgfx::Image> makeImage(RenderCache*) const override {
+    auto image = weakImage.lock();
+    if (image == nullptr) {
+      return nullptr;
+    }
+    return image->getImage(targetFrame);
+  }
+
+ private:
+  std::weak_ptr<AnimatedImage> weakImage;
+  int _width = 0;
+  int _height = 0;
+  Frame targetFrame = 0;
+};
+
+static bool IsImageFile(const std::string& filePath) {
+  auto fileName = Directory::GetFileName(filePath);
+  auto index = fileName.rfind('.');
+  if (index == std::string::npos) {
+    return false;
+  }
+  auto extension = fileName.substr(index + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "webp";
+}
+
+std::shared_ptr<PAGImage> PAGImage::FromImageSequence(const std::string& directory,
+                                                      float frameRate) {
+  std::vector<std::string> filePaths = {};
+  Directory::VisitFiles(directory, [&](const std::string& path, size_t) {
+    if (IsImageFile(path)) {
+      filePaths.push_back(path);
+    }
+  });
+  if (filePaths.empty()) {
+    LOGE("PAGImage.FromImageSequence() There is no image file in the directory: %s",
+         directory.c_str());
+    return nullptr;
+  }
+  std::sort(filePaths.begin(), filePaths.end());
+  auto reader = ImageSequenceReader::Make(std::move(filePaths));
+  if (reader == nullptr) {
+    return nullptr;
+  }
+  auto numFrames = reader->numFrames();
+  return AnimatedImage::MakeFrom(std::move(reader), numFrames, frameRate);
+}
+
+std::shared_ptr<PAGImage> PAGImage::FromVideoPath(const std::string& filePath) {
+  auto demuxer = MP4Demuxer::Make(filePath);
+  if (demuxer == nullptr) {
+    return nullptr;
+  }
+  auto numFrames = demuxer->sampleCount();
+  auto frameRate = demuxer->getFormat().frameRate;
+  auto reader = std::make_shared<VideoReader>(std::move(demuxer));
+  return AnimatedImage::MakeFrom(std::move(reader), numFrames, frameRate);
+}
+
+std::shared_ptr<AnimatedImage> AnimatedImage::MakeFrom(std::shared_ptr<SequenceReader> reader,
+                                                       Frame numFrames, float frameRate) {
+  if (reader == nullptr || numFrames <= 0 || frameRate <= 0) {
+    return nullptr;
+  }
+  auto image =
+      std::shared_ptr<AnimatedImage>(new AnimatedImage(std::move(reader), numFrames, frameRate));
+  image->weakThis = image;
+  return image;
+}
+
+AnimatedImage::AnimatedImage(std::shared_ptr<SequenceReader> reader, Frame numFrames,
+                             float frameRate)
+    : PAGImage(reader->width(), reader->height()), reader(std::move(reader)),
+      numFrames(numFrames), frameRate(frameRate) {
+#ifndef PAG_BUILD_FOR_WEB
+  // Unlike the sequences in PAG files, at least the next frame is always decoded ahead, since the
+  // frames of an external source usually take much longer to decode.
+  maxPrefetchCount = static_cast<size_t>(PAGSequencePrefetch::MaxFrameCount());
+  maxPrefetchMemory = PAGSequencePrefetch::MaxMemory();
+  prefetcher = SequencePrefetcher::Make(this->reader);
+#endif
+}
+
+AnimatedImage::~AnimatedImage() {
+  // The frames that are not decoded yet are skipped by the prefetcher once they are released.
+  prefetchedFrames.clear();
+}
+
+std::shared_ptr<Graphic> AnimatedImage::getGraphic(Frame frame) const {
+  auto proxy = std::make_shared<AnimatedImageProxy>(weakThis, width(), height(), frame);
+  return Picture::MakeFrom(uniqueID(), std::move(proxy));
+}
+
+Frame AnimatedImage::getContentFrame(int64_t time) const {
+  auto frame = TimeToFrame(time, frameRate);
+  // Holds the first or the last frame if the time is out of the source duration.
+  return std::max(static_cast<Frame>(0), std::min(frame, numFrames - 1));
+}
+
+void AnimatedImage::prepare(Frame targetFrame) {
+  std::lock_guard<std::mutex> autoLock(frameLocker);
+  if (prefetcher == nullptr || targetFrame == currentFrame) {
+    return;
+  }
+  auto result = std::find_if(prefetchedFrames.begin(), prefetchedFrames.end(),
+                             [targetFrame](const std::shared_ptr<PrefetchedFrame>& frame) {
+                               return frame->frame == targetFrame;
+                             });
+  // Drops all frames if the target frame is not scheduled, which means seeking happens.
+  prefetchedFrames.erase(prefetchedFrames.begin(), result);
+  prefetchFramesAfter(targetFrame - 1);
+}
+
+void AnimatedImage::prefetchFramesAfter(Frame targetFrame) {
+  // Use 4 bytes per pixel as the upper bound of the memory of a decoded frame.
+  auto frameBytes = static_cast<size_t>(width() * height()) * 4;
+  auto nextFrame = prefetchedFrames.empty() ? targetFrame + 1 : prefetchedFrames.back()->frame + 1;
+  while (prefetchedFrames.size() < maxPrefetchCount && nextFrame < numFrames) {
+    if (!prefetchedFrames.empty() && maxPrefetchMemory > 0 &&
+        (prefetchedFrames.size() + 1) * frameBytes > maxPrefetchMemory) {
+      break;
+    }
+    auto frame = std::make_shared<PrefetchedFrame>(nextFrame);
+    prefetcher->schedule(frame);
+    prefetchedFrames.push_back(frame);
+    nextFrame++;
+  }
+}
+
+std::shared_ptr<tgfx::ImageBuffer> AnimatedImage::getPrefetchedBuffer(Frame targetFrame) {
+  while (!prefetchedFrames.empty() && prefetchedFrames.front()->frame != targetFrame) {
+    prefetchedFrames.pop_front();
+  }
+  if (prefetchedFrames.empty()) {
+    // The buffer must not share memory with the reader, since the following frames are decoded
+    // while it is waiting to be drawn.
+    return reader->readOwnedBuffer(targetFrame);
+  }
+  auto frame = prefetchedFrames.front();
+  prefetchedFrames.pop_front();
+  return prefetcher->wait(frame.get());
+}
+
+std::shared_ptr<tgfx::Image> AnimatedImage::getImage(Frame targetFrame) {
+  std::lock_guard<std::mutex> autoLock(frameLocker);
+  if (targetFrame == currentFrame) {
+    return currentImage;
+  }
+  std::shared_ptr<tgfx::ImageBuffer> buffer = nullptr;
+  if (prefetcher != nullptr) {
+    buffer = getPrefetchedBuffer(targetFrame);
+    if (buffer == nullptr) {
+      // Decodes the frame synchronously below. If it keeps failing, the reader can not make owned
+      // buffers, such as the ones from hardware video decoders. Fall back to decoding frames on
+      // demand.
+      prefetchedFrames.clear();
+      prefetcher->cancel();
+      if (++prefetchFailures >= MAX_PREFETCH_FAILURES) {
+        prefetcher = nullptr;
+      }
+    } else {
+      prefetchFailures = 0;
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = reader->readBuffer(targetFrame);
+  }
+  if (buffer == nullptr) {
+    return nullptr;
+  }
+  currentImage = tgfx::Image::MakeFrom(std::move(buffer));
+  currentFrame = targetFrame;
+  if (prefetcher != nullptr) {
+    prefetchFramesAfter(targetFrame);
+  }
+  return currentImage;
+}
+}  // namespace pag
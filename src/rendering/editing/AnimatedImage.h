@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <deque>
+#include "pag/pag.h"
+#include "rendering/graphics/Graphic.h"
+#include "rendering/sequences/SequencePrefetcher.h"
+#include "rendering/sequences/SequenceReader.h"
+
+namespace pag {
+/**
+ * AnimatedImage is a time-varying PAGImage whose frames are decoded from a SequenceReader, such as
+ * an image file sequence or a video file. The frames following the current one are decoded ahead
+ * in background threads.
+ */
+class AnimatedImage : public PAGImage {
+ public:
+  /**
+   * Creates an AnimatedImage from the specified reader. Returns nullptr if the reader is null or
+   * the numFrames or the frameRate is not positive.
+   */
+  static std::shared_ptr<AnimatedImage> MakeFrom(std::shared_ptr<SequenceReader> reader,
+                                                 Frame numFrames, float frameRate);
+
+  ~AnimatedImage() override;
+
+ protected:
+  std::shared_ptr<Graphic> getGraphic(Frame frame) const override;
+
+  bool isStill() const override {
+    return false;
+  }
+
+  Frame getContentFrame(int64_t time) const override;
+
+ private:
+  std::mutex frameLocker = {};
+  std::weak_ptr<AnimatedImage> weakThis;
+  std::shared_ptr<SequenceReader> reader = nullptr;
+  Frame numFrames = 0;
+  float frameRate = 30.0f;
+  Frame currentFrame = -1;
+  std::shared_ptr<tgfx::Image> currentImage = nullptr;
+  std::shared_ptr<SequencePrefetcher> prefetcher = nullptr;
+  std::deque<std::shared_ptr<PrefetchedFrame>> prefetchedFrames = {};
+  int prefetchFailures = 0;
+  size_t maxPrefetchCount = 1;
+  size_t maxPrefetchMemory = 0;
+
+  AnimatedImage(std::shared_ptr<SequenceReader> reader, Frame numFrames, float frameRate);
+
+  void prepare(Frame targetFrame);
+
+  std::shared_ptr<tgfx::Image> getImage(Frame targetFrame);
+
+  void prefetchFramesAfter(Frame targetFrame);
+
+  std::shared_ptr<tgfx::ImageBuffer> getPrefetchedBuffer(Frame targetFrame);
+
+  friend class AnimatedImageProxy;
+};
+}  // namespace pag
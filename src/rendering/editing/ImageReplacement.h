@@ -37,5 +37,7 @@ class ImageReplacement : public Content {
   int contentWidth = 0;
   int contentHeight = 0;
   Frame contentFrame = -1;
+
+  friend class DamageTracker;
 };
 }  // namespace pag
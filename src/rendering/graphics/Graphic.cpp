@@ -50,6 +50,10 @@ class MatrixGraphic : public ComposeGraphic {
   void draw(Canvas* canvas) const override;
   std::shared_ptr<Graphic> mergeWith(const tgfx::Matrix& matrix) const override;
 
+  size_t memoryUsage() const override {
+    return sizeof(MatrixGraphic) + graphic->memoryUsage();
+  }
+
  protected:
   std::shared_ptr<Graphic> graphic = nullptr;
   tgfx::Matrix matrix = {};
@@ -130,6 +134,14 @@ class LayerGraphic : public ComposeGraphic {
   void draw(Canvas* canvas) const override;
   std::shared_ptr<Graphic> mergeWith(const tgfx::Matrix& matrix) const override;
 
+  size_t memoryUsage() const override {
+    auto memory = sizeof(LayerGraphic);
+    for (auto& content : contents) {
+      memory += content->memoryUsage();
+    }
+    return memory;
+  }
+
  private:
   std::vector<std::shared_ptr<Graphic>> contents = {};
 };
@@ -223,6 +235,10 @@ class ModifierGraphic : public ComposeGraphic {
   void draw(Canvas* canvas) const override;
   std::shared_ptr<Graphic> mergeWith(const Modifier* target) const override;
 
+  size_t memoryUsage() const override {
+    return sizeof(ModifierGraphic) + graphic->memoryUsage();
+  }
+
  private:
   std::shared_ptr<Graphic> graphic = nullptr;
   std::shared_ptr<Modifier> modifier = nullptr;
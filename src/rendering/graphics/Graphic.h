@@ -87,6 +87,14 @@ class Graphic {
    */
   virtual bool getPath(tgfx::Path* path) const = 0;
 
+  /**
+   * Returns the estimated CPU memory retained by this Graphic in bytes. GPU resources and decoded
+   * images are managed by RenderCache and not included.
+   */
+  virtual size_t memoryUsage() const {
+    return 0;
+  }
+
   /**
    * Prepares this graphic for next draw() call. It collects all CPU tasks in this Graphic and run
    * them in parallel immediately.
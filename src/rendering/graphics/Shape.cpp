@@ -61,6 +61,10 @@ bool Shape::getPath(tgfx::Path* result) const {
   return true;
 }
 
+size_t Shape::memoryUsage() const {
+  return sizeof(Shape) + static_cast<size_t>(path.countPoints()) * sizeof(tgfx::Point);
+}
+
 void Shape::prepare(RenderCache*) const {
 }
 
@@ -43,6 +43,7 @@ class Shape : public Graphic {
   void measureBounds(tgfx::Rect* bounds) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(tgfx::Path* result) const override;
+  size_t memoryUsage() const override;
   void prepare(RenderCache* cache) const override;
   void draw(Canvas* canvas) const override;
 
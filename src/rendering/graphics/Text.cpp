@@ -234,6 +234,15 @@ bool Text::getPath(tgfx::Path* path) const {
   return true;
 }
 
+size_t Text::memoryUsage() const {
+  auto memory = sizeof(Text) + glyphs.size() * sizeof(GlyphHandle);
+  for (auto& textRun : textRuns) {
+    memory += sizeof(TextRun) + textRun->glyphIDs.size() * sizeof(tgfx::GlyphID) +
+              textRun->positions.size() * sizeof(tgfx::Point);
+  }
+  return memory;
+}
+
 void Text::prepare(RenderCache*) const {
 }
 
@@ -57,6 +57,7 @@ class Text : public Graphic {
   void measureBounds(tgfx::Rect* rect) const override;
   bool hitTest(RenderCache* cache, float x, float y) override;
   bool getPath(tgfx::Path* path) const override;
+  size_t memoryUsage() const override;
   void prepare(RenderCache* cache) const override;
   void draw(Canvas* canvas) const override;
 
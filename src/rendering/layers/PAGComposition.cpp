@@ -21,6 +21,7 @@
 #include "pag/file.h"
 #include "pag/pag.h"
 #include "rendering/caches/CompositionCache.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/graphics/Recorder.h"
@@ -377,8 +378,7 @@ float PAGComposition::frameRateInternal() const {
   return _frameRate;
 }
 
-bool PAGComposition::gotoTime(int64_t layerTime) {
-  auto changed = PAGLayer::gotoTime(layerTime);
+int64_t PAGComposition::childTimeOffset() const {
   auto compositionOffset =
       static_cast<PreComposeLayer*>(layer)->compositionStartTime - layer->startTime + startFrame;
   /// 这里用floor取帧数是为了防止compositionOffsetTime变大导致layerTime变小导致显示帧数不正确。
@@ -386,8 +386,12 @@ bool PAGComposition::gotoTime(int64_t layerTime) {
   /// 此时如果取ceil compositionOffsetTime = 33334， subLayerTime = 66666，subLayerFrame = 1.9998
   /// 即显示第1帧， 但纯用frame计算时，gotoFrame = 2，因此此时不能取ceil，而要取floor来保证
   /// layerTime时间足够
-  auto compositionOffsetTime =
-      static_cast<Frame>(floor(compositionOffset * 1000000.0 / frameRateInternal()));
+  return static_cast<Frame>(floor(compositionOffset * 1000000.0 / frameRateInternal()));
+}
+
+bool PAGComposition::gotoTime(int64_t layerTime) {
+  auto changed = PAGLayer::gotoTime(layerTime);
+  auto compositionOffsetTime = childTimeOffset();
   for (auto& layer : layers) {
     if (layer->_excludedFromTimeline) {
       continue;
@@ -399,6 +403,22 @@ bool PAGComposition::gotoTime(int64_t layerTime) {
   return changed;
 }
 
+bool PAGComposition::collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) {
+  if (!PAGLayer::collectVaryingTimeRanges(timeOffset, timeRanges)) {
+    return false;
+  }
+  auto childOffset = timeOffset + childTimeOffset();
+  for (auto& layer : layers) {
+    if (layer->_excludedFromTimeline) {
+      continue;
+    }
+    if (!layer->collectVaryingTimeRanges(childOffset, timeRanges)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void PAGComposition::draw(Recorder* recorder) {
   if (!contentModified() && layerCache->contentStatic()) {
     // 子项未发生任何修改且内容是静态的，可以使用缓存快速跳过所有子项绘制。
@@ -503,6 +523,7 @@ std::vector<std::shared_ptr<PAGLayer>> PAGComposition::getLayersByName(
 std::vector<std::shared_ptr<PAGLayer>> PAGComposition::getLayersUnderPoint(float localX,
                                                                            float localY) {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   std::vector<std::shared_ptr<PAGLayer>> results;
   getLayersUnderPointInternal(localX, localY, &results);
   return results;
@@ -207,6 +207,55 @@ std::shared_ptr<PAGFile> PAGFile::copyOriginal() {
   return MakeFrom(file);
 }
 
+std::shared_ptr<PAGFile> PAGFile::copyWithEdits() {
+  LockGuard autoLock(rootLocker);
+  auto pagFile = MakeFrom(file);
+  if (pagFile == nullptr) {
+    return nullptr;
+  }
+  auto allLayers = [](PAGLayer*) -> bool { return true; };
+  auto sourceLayers = getLayersBy(allLayers);
+  auto targetLayers = pagFile->getLayersBy(allLayers);
+  if (sourceLayers.size() != targetLayers.size()) {
+    // The layer structure has been modified, which can not be reproduced from the original file.
+    return nullptr;
+  }
+  for (size_t i = 0; i < sourceLayers.size(); i++) {
+    auto source = sourceLayers[i].get();
+    auto target = targetLayers[i].get();
+    if (source->layer != target->layer) {
+      return nullptr;
+    }
+    target->setMatrixInternal(source->layerMatrix);
+    target->setVisibleInternal(source->layerVisible);
+    target->layerAlpha = source->layerAlpha;
+    target->_excludedFromTimeline = source->_excludedFromTimeline;
+    if (source != this) {
+      target->setStartTimeInternal(source->startTimeInternal());
+    }
+    if (source->layerType() == LayerType::Text) {
+      auto textLayer = static_cast<PAGTextLayer*>(source);
+      if (textLayer->replacement != nullptr) {
+        auto textData = std::make_shared<TextDocument>(*textLayer->textDocumentForRead());
+        static_cast<PAGTextLayer*>(target)->replaceTextInternal(textData);
+      }
+    } else if (source->layerType() == LayerType::Image) {
+      auto pagImage = static_cast<PAGImageLayer*>(source)->getPAGImage();
+      if (pagImage != nullptr && !pagImage->isStill()) {
+        // A time-varying image decodes its frames through a single reader, the copies would seek
+        // it back and forth from different threads.
+        return nullptr;
+      }
+      if (pagImage != nullptr) {
+        static_cast<PAGImageLayer*>(target)->setImageInternal(pagImage);
+      }
+    }
+  }
+  pagFile->_timeStretchMode = _timeStretchMode;
+  pagFile->setDurationInternal(durationInternal());
+  return pagFile;
+}
+
 bool PAGFile::isPAGFile() const {
   return true;
 }
@@ -255,6 +304,15 @@ bool PAGFile::gotoTime(int64_t layerTime) {
   return PAGComposition::gotoTime(fileTime);
 }
 
+bool PAGFile::collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) {
+  if (_stretchedFrameDuration != layer->duration) {
+    // The stretched time maps to the file time by scaling or repeating, which does not keep the
+    // time ranges contiguous.
+    return false;
+  }
+  return PAGComposition::collectVaryingTimeRanges(timeOffset, timeRanges);
+}
+
 Frame PAGFile::childFrameToLocal(pag::Frame childFrame, float childFrameRate) const {
   childFrame = PAGComposition::childFrameToLocal(childFrame, childFrameRate);
   if (_stretchedFrameDuration != layer->duration) {
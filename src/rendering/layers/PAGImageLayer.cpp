@@ -171,6 +171,13 @@ bool PAGImageLayer::gotoTime(int64_t layerTime) {
   return changed;
 }
 
+bool PAGImageLayer::collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) {
+  if (replacement != nullptr && !replacement->getImage()->isStill()) {
+    return false;
+  }
+  return PAGLayer::collectVaryingTimeRanges(timeOffset, timeRanges);
+}
+
 void PAGImageLayer::replaceImage(std::shared_ptr<pag::PAGImage> image) {
   LockGuard autoLock(rootLocker);
   if (rootFile != nullptr) {
@@ -20,12 +20,14 @@
 #include "base/utils/TimeUtil.h"
 #include "base/utils/UniqueID.h"
 #include "pag/pag.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 #include "rendering/caches/RenderCache.h"
 #include "rendering/layers/PAGStage.h"
 #include "rendering/renderers/TrackMatteRenderer.h"
 #include "rendering/utils/LockGuard.h"
 #include "rendering/utils/ScopedLock.h"
+#include "rendering/utils/VaryingTimeRanges.h"
 
 namespace pag {
 PAGLayer::PAGLayer(std::shared_ptr<File> file, Layer* layer)
@@ -74,6 +76,7 @@ void PAGLayer::resetMatrix() {
 
 Matrix PAGLayer::getTotalMatrix() {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   return getTotalMatrixInternal();
 }
 
@@ -117,6 +120,7 @@ void PAGLayer::setVisibleInternal(bool value) {
 
 Rect PAGLayer::getBounds() {
   LockGuard autoLock(rootLocker);
+  FrameCachePins framePins = {};
   Rect bounds = {};
   measureBounds(ToTGFX(&bounds));
   return bounds;
@@ -446,6 +450,15 @@ bool PAGLayer::gotoTime(int64_t layerTime) {
   return changed;
 }
 
+bool PAGLayer::collectVaryingTimeRanges(int64_t timeOffset, VaryingTimeRanges* timeRanges) {
+  if (_trackMatteLayer != nullptr &&
+      !_trackMatteLayer->collectVaryingTimeRanges(timeOffset, timeRanges)) {
+    return false;
+  }
+  timeRanges->addLayer(layerCache, startFrame, frameRateInternal(), timeOffset);
+  return true;
+}
+
 void PAGLayer::draw(Recorder* recorder) {
   getContent()->draw(recorder);
 }
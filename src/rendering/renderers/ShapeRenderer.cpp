@@ -24,6 +24,7 @@
 #include "base/utils/Interpolate.h"
 #include "base/utils/MathUtil.h"
 #include "base/utils/TGFXCast.h"
+#include "rendering/caches/PathCache.h"
 #include "rendering/graphics/GradientPaint.h"
 #include "rendering/graphics/Graphic.h"
 #include "rendering/graphics/Shape.h"
@@ -135,6 +136,7 @@ class GroupElement : public ElementData {
     auto newGroup = new GroupElement();
     newGroup->blendMode = blendMode;
     newGroup->alpha = alpha;
+    newGroup->pathCache = pathCache;
     for (auto& data : elements) {
       auto element = data->clone().release();
       newGroup->elements.push_back(element);
@@ -178,6 +180,8 @@ class GroupElement : public ElementData {
   tgfx::BlendMode blendMode = tgfx::BlendMode::SrcOver;
   float alpha = 1.0f;
   std::vector<ElementData*> elements;
+  // Caches the results of expensive path operations across frames, could be nullptr.
+  PathCache* pathCache = nullptr;
 };
 
 void RectangleToPath(RectangleElement* rectangle, tgfx::Path* path, Frame frame) {
@@ -541,6 +545,37 @@ void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*> pathLi
   ApplyTrimPaths(trimPaths, pathList, start, end, reversed);
 }
 
+static std::vector<tgfx::Path> CopyPaths(const std::vector<tgfx::Path*>& pathList) {
+  std::vector<tgfx::Path> paths = {};
+  paths.reserve(pathList.size());
+  for (auto& path : pathList) {
+    paths.push_back(*path);
+  }
+  return paths;
+}
+
+void ApplyTrimPaths(TrimPathsElement* trimPaths, std::vector<tgfx::Path*> pathList, Frame frame,
+                    PathCache* pathCache) {
+  if (pathCache == nullptr) {
+    ApplyTrimPaths(trimPaths, pathList, frame);
+    return;
+  }
+  PathKey key = {};
+  key.paths = CopyPaths(pathList);
+  key.parameters = {trimPaths->start->getValueAt(frame), trimPaths->end->getValueAt(frame),
+                    trimPaths->offset->getValueAt(frame),
+                    static_cast<float>(trimPaths->trimType)};
+  std::vector<tgfx::Path> results = {};
+  if (pathCache->find(key, &results) && results.size() == pathList.size()) {
+    for (size_t i = 0; i < pathList.size(); i++) {
+      *pathList[i] = results[i];
+    }
+    return;
+  }
+  ApplyTrimPaths(trimPaths, pathList, frame);
+  pathCache->add(key, CopyPaths(pathList));
+}
+
 void ApplyMergePaths(MergePathsElement* mergePaths, GroupElement* group) {
   auto pathList = group->pathList();
   if (pathList.empty()) {
@@ -564,11 +599,26 @@ void ApplyMergePaths(MergePathsElement* mergePaths, GroupElement* group) {
       pathOp = tgfx::PathOp::Union;
       break;
   }
-  auto tempPath = *(pathList[0]);
-  auto size = static_cast<int>(pathList.size());
-  for (int i = 1; i < size; i++) {
-    auto path = pathList[i];
-    tempPath.addPath(*path, pathOp);
+  PathKey key = {};
+  std::vector<tgfx::Path> results = {};
+  if (group->pathCache != nullptr) {
+    key.paths = CopyPaths(pathList);
+    key.parameters = {static_cast<float>(mergePaths->mode)};
+  }
+  tgfx::Path tempPath = {};
+  if (group->pathCache != nullptr && group->pathCache->find(key, &results) &&
+      results.size() == 1) {
+    tempPath = results[0];
+  } else {
+    tempPath = *(pathList[0]);
+    auto size = static_cast<int>(pathList.size());
+    for (int i = 1; i < size; i++) {
+      auto path = pathList[i];
+      tempPath.addPath(*path, pathOp);
+    }
+    if (group->pathCache != nullptr) {
+      group->pathCache->add(key, {tempPath});
+    }
   }
   group->clear();
   auto pathElement = new PathElement();
@@ -683,6 +733,7 @@ void RenderElements_ShapeGroup(ShapeElement* element, const tgfx::Matrix& parent
   auto transform = ShapeTransformToTransform(shape->transform, frame);
   transform.matrix.postConcat(parentMatrix);
   auto group = new GroupElement();
+  group->pathCache = parentGroup->pathCache;
   group->alpha = transform.alpha;
   group->blendMode = ToTGFXBlend(shape->blendMode);
   RenderElements(shape->elements, transform.matrix, group, frame);
@@ -769,7 +820,8 @@ void RenderElements_Repeater(ShapeElement* element, const tgfx::Matrix&, GroupEl
 
 void RenderElements_TrimPaths(ShapeElement* element, const tgfx::Matrix&, GroupElement* parentGroup,
                               Frame frame) {
-  ApplyTrimPaths(static_cast<TrimPathsElement*>(element), parentGroup->pathList(), frame);
+  ApplyTrimPaths(static_cast<TrimPathsElement*>(element), parentGroup->pathList(), frame,
+                 parentGroup->pathCache);
 }
 
 void RenderElements_RoundCorners(ShapeElement* element, const tgfx::Matrix& parentMatrix,
@@ -859,11 +911,34 @@ void ApplyStrokeToPath(tgfx::Path* path, const StrokePaint& stroke) {
   }
 }
 
-std::shared_ptr<Graphic> RenderShape(ID assetID, PaintElement* paint, tgfx::Path* path) {
+static void ApplyStrokeToPath(tgfx::Path* path, const StrokePaint& stroke, PathCache* pathCache) {
+  if (pathCache == nullptr) {
+    ApplyStrokeToPath(path, stroke);
+    return;
+  }
+  PathKey key = {};
+  key.paths = {*path};
+  auto& matrix = stroke.matrix;
+  key.parameters = {stroke.strokeWidth, static_cast<float>(stroke.lineCap),
+                    static_cast<float>(stroke.lineJoin), stroke.miterLimit, stroke.dashOffset,
+                    matrix.getScaleX(), matrix.getSkewX(), matrix.getTranslateX(),
+                    matrix.getSkewY(), matrix.getScaleY(), matrix.getTranslateY()};
+  key.parameters.insert(key.parameters.end(), stroke.dashes.begin(), stroke.dashes.end());
+  std::vector<tgfx::Path> results = {};
+  if (pathCache->find(key, &results) && results.size() == 1) {
+    *path = results[0];
+    return;
+  }
+  ApplyStrokeToPath(path, stroke);
+  pathCache->add(key, {*path});
+}
+
+std::shared_ptr<Graphic> RenderShape(ID assetID, PaintElement* paint, tgfx::Path* path,
+                                     PathCache* pathCache) {
   tgfx::Path shapePath = *path;
   auto paintType = paint->paintType;
   if (paintType == PaintType::Stroke || paintType == PaintType::GradientStroke) {
-    ApplyStrokeToPath(&shapePath, paint->stroke);
+    ApplyStrokeToPath(&shapePath, paint->stroke, pathCache);
   } else if (shapePath.isLine()) {
     return nullptr;
   }
@@ -890,7 +965,7 @@ std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path
       } break;
       case ElementDataType::Paint: {
         auto paint = reinterpret_cast<PaintElement*>(element);
-        auto shape = RenderShape(assetID, paint, path);
+        auto shape = RenderShape(assetID, paint, path, group->pathCache);
         if (shape) {
           if (paint->compositeOrder == CompositeOrder::AbovePreviousInSameGroup) {
             contents.push_back(shape);
@@ -915,8 +990,9 @@ std::shared_ptr<Graphic> RenderShape(ID assetID, GroupElement* group, tgfx::Path
 }
 
 std::shared_ptr<Graphic> RenderShapes(ID assetID, const std::vector<ShapeElement*>& contents,
-                                      Frame layerFrame) {
+                                      Frame layerFrame, PathCache* pathCache) {
   GroupElement rootGroup;
+  rootGroup.pathCache = pathCache;
   auto matrix = tgfx::Matrix::I();
   RenderElements(contents, matrix, &rootGroup, layerFrame);
   tgfx::Path tempPath = {};
@@ -19,10 +19,15 @@
 #pragma once
 
 #include "pag/file.h"
+#include "rendering/caches/PathCache.h"
 #include "rendering/graphics/Recorder.h"
 #include "rendering/utils/Transform.h"
 
 namespace pag {
+/**
+ * Renders the shape contents at the specified frame. The results of expensive path operations are
+ * reused from the pathCache if it is not nullptr.
+ */
 std::shared_ptr<Graphic> RenderShapes(ID assetID, const std::vector<ShapeElement*>& contents,
-                                      Frame layerFrame);
+                                      Frame layerFrame, PathCache* pathCache = nullptr);
 }
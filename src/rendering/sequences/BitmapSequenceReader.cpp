@@ -47,6 +47,20 @@ BitmapSequenceReader::~BitmapSequenceReader() {
 std::shared_ptr<tgfx::ImageBuffer> BitmapSequenceReader::onMakeBuffer(Frame targetFrame) {
   // a locker is required here because decodeFrame() could be called from multiple threads.
   std::lock_guard<std::mutex> autoLock(locker);
+  return decodeBuffer(targetFrame);
+}
+
+std::shared_ptr<tgfx::ImageBuffer> BitmapSequenceReader::onMakeOwnedBuffer(Frame targetFrame) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (decodeBuffer(targetFrame) == nullptr || pixels == nullptr) {
+    return nullptr;
+  }
+  // The pixels are overwritten by the next frame, so make a copy of them while holding the locker.
+  auto data = tgfx::Data::MakeWithCopy(pixels->data(), pixels->size());
+  return tgfx::ImageBuffer::MakeFrom(info, std::move(data));
+}
+
+std::shared_ptr<tgfx::ImageBuffer> BitmapSequenceReader::decodeBuffer(Frame targetFrame) {
   if (lastDecodeFrame == targetFrame) {
     return imageBuffer;
   }
@@ -41,10 +41,14 @@ class BitmapSequenceReader : public SequenceReader {
  protected:
   std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
 
+  std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame targetFrame) override;
+
   void onReportPerformance(Performance* performance, int64_t decodingTime) override;
 
   Frame findStartFrame(Frame targetFrame);
 
+  std::shared_ptr<tgfx::ImageBuffer> decodeBuffer(Frame targetFrame);
+
   std::mutex locker = {};
   // Keep a reference to the File in case the Sequence object is released while we are using it.
   std::shared_ptr<File> file = nullptr;
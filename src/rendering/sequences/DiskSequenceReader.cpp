@@ -55,6 +55,20 @@ int DiskSequenceReader::height() const {
 std::shared_ptr<tgfx::ImageBuffer> DiskSequenceReader::onMakeBuffer(Frame targetFrame) {
   // Need a locker here in case there are other threads are decoding at the same time.
   std::lock_guard<std::mutex> autoLock(locker);
+  return decodeBuffer(targetFrame);
+}
+
+std::shared_ptr<tgfx::ImageBuffer> DiskSequenceReader::onMakeOwnedBuffer(Frame targetFrame) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (decodeBuffer(targetFrame) == nullptr || pixels == nullptr) {
+    // The hardware buffers can not be copied, they are reused by the following frames.
+    return nullptr;
+  }
+  auto data = tgfx::Data::MakeWithCopy(pixels->data(), pixels->size());
+  return tgfx::ImageBuffer::MakeFrom(info, std::move(data));
+}
+
+std::shared_ptr<tgfx::ImageBuffer> DiskSequenceReader::decodeBuffer(Frame targetFrame) {
   if (pagDecoder == nullptr) {
     auto root = PAGComposition::Make(sequence->width, sequence->height);
     auto composition = std::make_shared<PAGComposition>(
@@ -37,6 +37,8 @@ class DiskSequenceReader : public SequenceReader {
   std::shared_ptr<PAGDecoder> pagDecoder;
   std::shared_ptr<File> file;
   std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
+  std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame targetFrame) override;
+  std::shared_ptr<tgfx::ImageBuffer> decodeBuffer(Frame targetFrame);
   void onReportPerformance(Performance* performance, int64_t decodingTime) override;
   std::shared_ptr<tgfx::ImageBuffer> imageBuffer = nullptr;
   std::mutex locker = {};
@@ -0,0 +1,70 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ImageSequenceReader.h"
+#include "base/utils/Log.h"
+#include "tgfx/core/ImageCodec.h"
+#include "tgfx/utils/Buffer.h"
+
+namespace pag {
+std::shared_ptr<ImageSequenceReader> ImageSequenceReader::Make(std::vector<std::string> filePaths) {
+  if (filePaths.empty()) {
+    return nullptr;
+  }
+  auto codec = tgfx::ImageCodec::MakeFrom(filePaths.front());
+  if (codec == nullptr) {
+    LOGE("ImageSequenceReader: Failed to decode the image file: %s", filePaths.front().c_str());
+    return nullptr;
+  }
+  return std::shared_ptr<ImageSequenceReader>(
+      new ImageSequenceReader(std::move(filePaths), codec->width(), codec->height()));
+}
+
+ImageSequenceReader::ImageSequenceReader(std::vector<std::string> filePaths, int width,
+                                         int height)
+    : filePaths(std::move(filePaths)), _width(width), _height(height) {
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ImageSequenceReader::onMakeBuffer(Frame targetFrame) {
+  if (targetFrame < 0 || targetFrame >= numFrames()) {
+    return nullptr;
+  }
+  auto& filePath = filePaths[static_cast<size_t>(targetFrame)];
+  auto codec = tgfx::ImageCodec::MakeFrom(filePath);
+  if (codec == nullptr || codec->width() != _width || codec->height() != _height) {
+    LOGE("ImageSequenceReader: The image file is invalid or has a different size: %s",
+         filePath.c_str());
+    return nullptr;
+  }
+  auto info = tgfx::ImageInfo::Make(_width, _height, tgfx::ColorType::RGBA_8888);
+  tgfx::Buffer buffer(info.byteSize());
+  if (buffer.isEmpty() || !codec->readPixels(info, buffer.bytes())) {
+    return nullptr;
+  }
+  return tgfx::ImageBuffer::MakeFrom(info, buffer.release());
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ImageSequenceReader::onMakeOwnedBuffer(Frame targetFrame) {
+  // Every frame is decoded into newly allocated pixels, which are never shared with the reader.
+  return onMakeBuffer(targetFrame);
+}
+
+void ImageSequenceReader::onReportPerformance(Performance* performance, int64_t decodingTime) {
+  performance->imageDecodingTime += decodingTime;
+}
+}  // namespace pag
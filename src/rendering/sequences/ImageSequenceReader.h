@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SequenceReader.h"
+
+namespace pag {
+/**
+ * ImageSequenceReader decodes the frames of a sequence from a list of image files, one file per
+ * frame. All the images are expected to have the same size as the first one.
+ */
+class ImageSequenceReader : public SequenceReader {
+ public:
+  /**
+   * Creates an ImageSequenceReader from the specified image files. Returns nullptr if the list is
+   * empty or the first file is not a valid image file.
+   */
+  static std::shared_ptr<ImageSequenceReader> Make(std::vector<std::string> filePaths);
+
+  int width() const override {
+    return _width;
+  }
+
+  int height() const override {
+    return _height;
+  }
+
+  /**
+   * Returns the number of frames in the sequence.
+   */
+  int numFrames() const {
+    return static_cast<int>(filePaths.size());
+  }
+
+ protected:
+  std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
+
+  std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame targetFrame) override;
+
+  void onReportPerformance(Performance* performance, int64_t decodingTime) override;
+
+ private:
+  std::vector<std::string> filePaths = {};
+  int _width = 0;
+  int _height = 0;
+
+  ImageSequenceReader(std::vector<std::string> filePaths, int width, int height);
+};
+}  // namespace pag
@@ -0,0 +1,216 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ParallelVideoReader.h"
+#include <algorithm>
+#include <atomic>
+#include "rendering/sequences/VideoSequenceDemuxer.h"
+#include "tgfx/utils/Task.h"
+
+namespace pag {
+static constexpr Frame MAX_LOOK_AHEAD_FRAMES = 90;
+static std::atomic_int maxParallelGOPCount = {1};
+
+void PAGVideoDecoder::SetMaxParallelGOPCount(int count) {
+  maxParallelGOPCount = std::max(count, 1);
+}
+
+std::shared_ptr<ParallelVideoReader> ParallelVideoReader::Make(std::shared_ptr<File> file,
+                                                               VideoSequence* sequence) {
+  auto maxGOPCount = maxParallelGOPCount.load();
+  if (file == nullptr || sequence == nullptr || maxGOPCount < 2) {
+    return nullptr;
+  }
+  std::vector<Frame> keyframes = {};
+  for (auto& frame : sequence->frames) {
+    if (frame->isKeyframe) {
+      keyframes.push_back(frame->frame);
+    }
+  }
+  if (keyframes.size() < 2 || keyframes.front() != 0) {
+    return nullptr;
+  }
+  auto reader = std::shared_ptr<ParallelVideoReader>(new ParallelVideoReader(
+      std::move(file), sequence, std::move(keyframes), static_cast<size_t>(maxGOPCount)));
+  reader->weakThis = reader;
+  return reader;
+}
+
+ParallelVideoReader::ParallelVideoReader(std::shared_ptr<File> file, VideoSequence* sequence,
+                                         std::vector<Frame> keyframes, size_t maxGOPCount)
+    : file(std::move(file)), sequence(sequence), keyframes(std::move(keyframes)),
+      maxGOPCount(maxGOPCount) {
+  auto demuxer = std::make_unique<VideoSequenceDemuxer>(this->file, sequence);
+  serialReader = std::make_shared<VideoReader>(std::move(demuxer));
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ParallelVideoReader::onMakeBuffer(Frame targetFrame) {
+  auto buffer = readParallelBuffer(targetFrame);
+  if (buffer != nullptr) {
+    return buffer;
+  }
+  return serialReader->readBuffer(targetFrame);
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ParallelVideoReader::onMakeOwnedBuffer(Frame targetFrame) {
+  auto buffer = readParallelBuffer(targetFrame);
+  if (buffer != nullptr) {
+    return buffer;
+  }
+  return serialReader->readOwnedBuffer(targetFrame);
+}
+
+void ParallelVideoReader::onReportPerformance(Performance* performance, int64_t) {
+  // The time spent on waiting for the GOPs is not reported, each VideoReader reports the time it
+  // spends on decoding instead.
+  std::vector<std::shared_ptr<VideoReader>> readers = {};
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    readers = gopReaders;
+  }
+  readers.push_back(serialReader);
+  for (auto& reader : readers) {
+    reader->reportPerformance(performance);
+  }
+}
+
+std::shared_ptr<tgfx::ImageBuffer> ParallelVideoReader::readParallelBuffer(Frame targetFrame) {
+  if (targetFrame < 0 || targetFrame >= sequence->duration()) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<GOPTask>> newTasks = {};
+  std::unique_lock<std::mutex> autoLock(locker);
+  if (parallelFailed) {
+    return nullptr;
+  }
+  auto task = scheduleGOPs(targetFrame, &newTasks);
+  autoLock.unlock();
+  for (auto& newTask : newTasks) {
+    std::weak_ptr<GOPTask> weakTask = newTask;
+    auto decodeTask = tgfx::Task::Run([reader = weakThis.lock(), weakTask]() {
+      reader->decodeGOP(weakTask);
+    });
+    if (decodeTask == nullptr) {
+      decodeGOP(weakTask);
+    }
+  }
+  autoLock.lock();
+  auto index = static_cast<size_t>(targetFrame - task->startFrame);
+  if (index < task->releasedFrames) {
+    // The frame has been released after the playback moved past it, read it from the serial reader
+    // instead.
+    return nullptr;
+  }
+  condition.wait(autoLock, [task, index] { return task->decodedFrames > index || task->finished; });
+  auto buffer = index < task->decodedFrames ? task->buffers[index] : nullptr;
+  if (buffer == nullptr) {
+    // The video decoders can not make owned buffers or fail to decode the frame, fall back to
+    // decoding the frames in order.
+    parallelFailed = true;
+    gopTasks.clear();
+    return nullptr;
+  }
+  for (auto i = task->releasedFrames; i < index; i++) {
+    task->buffers[i] = nullptr;
+  }
+  task->releasedFrames = index;
+  return buffer;
+}
+
+std::shared_ptr<ParallelVideoReader::GOPTask> ParallelVideoReader::scheduleGOPs(
+    Frame targetFrame, std::vector<std::shared_ptr<GOPTask>>* newTasks) {
+  auto result = std::upper_bound(keyframes.begin(), keyframes.end(), targetFrame);
+  auto gopIndex = static_cast<size_t>(result - keyframes.begin()) - 1;
+  auto gopCount = keyframes.size();
+  std::deque<std::shared_ptr<GOPTask>> tasks = {};
+  Frame lookAheadFrames = 0;
+  for (size_t i = 0; i < std::min(maxGOPCount, gopCount); i++) {
+    // Wraps around to the first GOP, since the sequences are usually played in a loop.
+    auto index = (gopIndex + i) % gopCount;
+    auto endFrame = index + 1 < gopCount ? keyframes[index + 1] : sequence->duration();
+    if (i > 0) {
+      // Every decoded frame of the GOPs ahead is kept in memory until it is played, stop decoding
+      // ahead once they exceed the budget.
+      lookAheadFrames += endFrame - keyframes[index];
+      if (lookAheadFrames > MAX_LOOK_AHEAD_FRAMES) {
+        break;
+      }
+    }
+    auto scheduled = std::find_if(gopTasks.begin(), gopTasks.end(),
+                                  [index](const std::shared_ptr<GOPTask>& task) {
+                                    return task->index == index;
+                                  });
+    if (scheduled != gopTasks.end()) {
+      tasks.push_back(*scheduled);
+      continue;
+    }
+    auto task = std::make_shared<GOPTask>(index, keyframes[index], endFrame);
+    tasks.push_back(task);
+    newTasks->push_back(task);
+  }
+  // The GOPs out of the window are released here, and their decoding stops at the next frame.
+  gopTasks = std::move(tasks);
+  return gopTasks.front();
+}
+
+void ParallelVideoReader::decodeGOP(std::weak_ptr<GOPTask> weakTask) {
+  auto reader = obtainReader();
+  while (true) {
+    auto task = weakTask.lock();
+    if (task == nullptr) {
+      break;
+    }
+    // Only this thread changes decodedFrames, so it can be read without locking.
+    auto index = task->decodedFrames;
+    std::shared_ptr<tgfx::ImageBuffer> buffer = nullptr;
+    if (index < task->buffers.size()) {
+      buffer = reader->readOwnedBuffer(task->startFrame + static_cast<Frame>(index));
+    }
+    std::lock_guard<std::mutex> autoLock(locker);
+    if (buffer == nullptr) {
+      task->finished = true;
+      condition.notify_all();
+      break;
+    }
+    task->buffers[index] = buffer;
+    task->decodedFrames++;
+    condition.notify_all();
+  }
+  recycleReader(std::move(reader));
+}
+
+std::shared_ptr<VideoReader> ParallelVideoReader::obtainReader() {
+  std::unique_lock<std::mutex> autoLock(locker);
+  if (idleReaders.empty() && gopReaders.size() < maxGOPCount) {
+    auto demuxer = std::make_unique<VideoSequenceDemuxer>(file, sequence);
+    auto reader = std::make_shared<VideoReader>(std::move(demuxer));
+    gopReaders.push_back(reader);
+    return reader;
+  }
+  condition.wait(autoLock, [this] { return !idleReaders.empty(); });
+  auto reader = idleReaders.back();
+  idleReaders.pop_back();
+  return reader;
+}
+
+void ParallelVideoReader::recycleReader(std::shared_ptr<VideoReader> reader) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  idleReaders.push_back(std::move(reader));
+  condition.notify_all();
+}
+}  // namespace pag
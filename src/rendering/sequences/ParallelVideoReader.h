@@ -0,0 +1,102 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "rendering/sequences/SequenceReader.h"
+#include "rendering/sequences/VideoReader.h"
+
+namespace pag {
+/**
+ * ParallelVideoReader splits a video sequence at its keyframes and decodes the GOPs around the
+ * requested frame with separate VideoReaders in background threads. The decoded frames are handed
+ * back in presentation order and released once the playback moves past them. The GOPs decoded
+ * ahead of the current one are limited by a frame budget. It falls back to one VideoReader decoding the frames in order if the
+ * video decoders can not make owned buffers, such as the hardware ones.
+ */
+class ParallelVideoReader : public SequenceReader {
+ public:
+  /**
+   * Creates a ParallelVideoReader if the sequence has more than one keyframe and the count set by
+   * PAGVideoDecoder::SetMaxParallelGOPCount() is larger than 1. Returns nullptr otherwise.
+   */
+  static std::shared_ptr<ParallelVideoReader> Make(std::shared_ptr<File> file,
+                                                   VideoSequence* sequence);
+
+  int width() const override {
+    return serialReader->width();
+  }
+
+  int height() const override {
+    return serialReader->height();
+  }
+
+ protected:
+  std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
+
+  std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame targetFrame) override;
+
+  void onReportPerformance(Performance* performance, int64_t decodingTime) override;
+
+ private:
+  struct GOPTask {
+    GOPTask(size_t index, Frame startFrame, Frame endFrame)
+        : index(index), startFrame(startFrame),
+          buffers(static_cast<size_t>(endFrame - startFrame)) {
+    }
+
+    size_t index = 0;
+    Frame startFrame = 0;
+    size_t decodedFrames = 0;
+    // The frames before it have been handed back and released.
+    size_t releasedFrames = 0;
+    bool finished = false;
+    std::vector<std::shared_ptr<tgfx::ImageBuffer>> buffers = {};
+  };
+
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  std::weak_ptr<ParallelVideoReader> weakThis;
+  std::shared_ptr<File> file = nullptr;
+  VideoSequence* sequence = nullptr;
+  std::vector<Frame> keyframes = {};
+  size_t maxGOPCount = 0;
+  std::shared_ptr<VideoReader> serialReader = nullptr;
+  std::vector<std::shared_ptr<VideoReader>> gopReaders = {};
+  std::vector<std::shared_ptr<VideoReader>> idleReaders = {};
+  std::deque<std::shared_ptr<GOPTask>> gopTasks = {};
+  bool parallelFailed = false;
+
+  ParallelVideoReader(std::shared_ptr<File> file, VideoSequence* sequence,
+                      std::vector<Frame> keyframes, size_t maxGOPCount);
+
+  std::shared_ptr<tgfx::ImageBuffer> readParallelBuffer(Frame targetFrame);
+
+  std::shared_ptr<GOPTask> scheduleGOPs(Frame targetFrame,
+                                        std::vector<std::shared_ptr<GOPTask>>* newTasks);
+
+  void decodeGOP(std::weak_ptr<GOPTask> weakTask);
+
+  std::shared_ptr<VideoReader> obtainReader();
+
+  void recycleReader(std::shared_ptr<VideoReader> reader);
+};
+}  // namespace pag
@@ -17,8 +17,29 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SequenceImageQueue.h"
+#include <algorithm>
+#include <atomic>
 
 namespace pag {
+static std::atomic<int> maxPrefetchFrameCount = {1};
+static std::atomic<size_t> maxPrefetchMemoryBytes = {32 * 1024 * 1024};
+
+int PAGSequencePrefetch::MaxFrameCount() {
+  return maxPrefetchFrameCount;
+}
+
+void PAGSequencePrefetch::SetMaxFrameCount(int count) {
+  maxPrefetchFrameCount = std::max(count, 1);
+}
+
+size_t PAGSequencePrefetch::MaxMemory() {
+  return maxPrefetchMemoryBytes;
+}
+
+void PAGSequencePrefetch::SetMaxMemory(size_t bytes) {
+  maxPrefetchMemoryBytes = bytes;
+}
+
 std::unique_ptr<SequenceImageQueue> SequenceImageQueue::MakeFrom(
     std::shared_ptr<SequenceInfo> sequence, PAGLayer* pagLayer, bool useDiskCache) {
   if (sequence == nullptr || pagLayer == nullptr || sequence->staticContent()) {
@@ -38,18 +59,41 @@ SequenceImageQueue::SequenceImageQueue(std::shared_ptr<SequenceInfo> sequence,
                                        bool useDiskCache)
     : sequence(sequence), reader(std::move(reader)), firstFrame(firstFrame),
       totalFrames(sequence->duration()), useDiskCache(useDiskCache) {
+#ifndef PAG_BUILD_FOR_WEB
+  maxPrefetchCount = static_cast<size_t>(PAGSequencePrefetch::MaxFrameCount());
+  maxPrefetchMemory = PAGSequencePrefetch::MaxMemory();
+  if (maxPrefetchCount > 1) {
+    prefetcher = SequencePrefetcher::Make(this->reader);
+  }
+#endif
 }
 
-void SequenceImageQueue::prepareNextImage() {
-  auto nextFrame = currentFrame + 1;
+SequenceImageQueue::~SequenceImageQueue() {
+  // The frames that are not decoded yet are skipped by the prefetcher once they are released.
+  prefetchedFrames.clear();
+}
+
+Frame SequenceImageQueue::nextFrameOf(Frame frame) const {
+  auto nextFrame = frame + 1;
   if (nextFrame >= totalFrames) {
     nextFrame = firstFrame;
   }
-  prepare(nextFrame);
+  return nextFrame;
+}
+
+void SequenceImageQueue::prepareNextImage() {
+  prepare(nextFrameOf(currentFrame));
 }
 
 void SequenceImageQueue::prepare(Frame targetFrame) {
-  if (preparedImage != nullptr || targetFrame < 0 || targetFrame >= totalFrames) {
+  if (targetFrame < 0 || targetFrame >= totalFrames) {
+    return;
+  }
+  if (prefetcher != nullptr) {
+    prefetch(targetFrame);
+    return;
+  }
+  if (preparedImage != nullptr) {
     return;
   }
   auto image = sequence->makeFrameImage(reader, targetFrame, useDiskCache);
@@ -57,11 +101,83 @@ void SequenceImageQueue::prepare(Frame targetFrame) {
   preparedFrame = targetFrame;
 }
 
+void SequenceImageQueue::prefetch(Frame targetFrame) {
+  if (targetFrame == currentFrame) {
+    return;
+  }
+  dropPrefetchedFramesBefore(targetFrame);
+  // Use 4 bytes per pixel as the upper bound of the memory of a decoded frame.
+  auto frameBytes = static_cast<size_t>(reader->width() * reader->height()) * 4;
+  auto nextFrame =
+      prefetchedFrames.empty() ? targetFrame : nextFrameOf(prefetchedFrames.back()->frame);
+  while (prefetchedFrames.size() < maxPrefetchCount) {
+    if (!prefetchedFrames.empty()) {
+      if (nextFrame == targetFrame) {
+        // All frames of the sequence have been scheduled.
+        break;
+      }
+      if (maxPrefetchMemory > 0 && (prefetchedFrames.size() + 1) * frameBytes > maxPrefetchMemory) {
+        break;
+      }
+    }
+    auto frame = std::make_shared<PrefetchedFrame>(nextFrame);
+    prefetcher->schedule(frame);
+    prefetchedFrames.push_back(frame);
+    nextFrame = nextFrameOf(nextFrame);
+  }
+  preparedFrame = targetFrame;
+}
+
+void SequenceImageQueue::dropPrefetchedFramesBefore(Frame targetFrame) {
+  auto result = std::find_if(prefetchedFrames.begin(), prefetchedFrames.end(),
+                             [targetFrame](const std::shared_ptr<PrefetchedFrame>& frame) {
+                               return frame->frame == targetFrame;
+                             });
+  // Drops all frames if the target frame is not scheduled, which means seeking happens.
+  prefetchedFrames.erase(prefetchedFrames.begin(), result);
+}
+
+std::shared_ptr<tgfx::Image> SequenceImageQueue::getPrefetchedImage(Frame targetFrame) {
+  dropPrefetchedFramesBefore(targetFrame);
+  std::shared_ptr<tgfx::ImageBuffer> buffer = nullptr;
+  if (prefetchedFrames.empty()) {
+    // The buffer must not share memory with the reader, since the following frames are decoded
+    // while it is waiting to be drawn.
+    buffer = reader->readOwnedBuffer(targetFrame);
+  } else {
+    auto frame = prefetchedFrames.front();
+    prefetchedFrames.pop_front();
+    buffer = prefetcher->wait(frame.get());
+  }
+  if (buffer == nullptr) {
+    // The frame is decoded synchronously by the caller instead. If it keeps failing, the reader can
+    // not make owned buffers, such as the ones from hardware video decoders. Fall back to decoding
+    // one frame ahead.
+    prefetchedFrames.clear();
+    prefetcher->cancel();
+    if (++prefetchFailures >= MAX_PREFETCH_FAILURES) {
+      prefetcher = nullptr;
+    }
+    return nullptr;
+  }
+  prefetchFailures = 0;
+  return sequence->makeFrameImage(std::move(buffer), useDiskCache);
+}
+
 std::shared_ptr<tgfx::Image> SequenceImageQueue::getImage(Frame targetFrame) {
   if (targetFrame == currentFrame) {
     return currentImage;
   }
-  if (targetFrame == preparedFrame) {
+  if (prefetcher != nullptr) {
+    auto image = getPrefetchedImage(targetFrame);
+    if (image != nullptr) {
+      currentImage = image;
+      currentFrame = targetFrame;
+      preparedFrame = prefetchedFrames.empty() ? targetFrame : prefetchedFrames.front()->frame;
+      return currentImage;
+    }
+  }
+  if (targetFrame == preparedFrame && preparedImage != nullptr) {
     currentImage = preparedImage;
     preparedImage = nullptr;
     currentFrame = preparedFrame;
@@ -80,5 +196,6 @@ std::shared_ptr<tgfx::Image> SequenceImageQueue::getImage(Frame targetFrame) {
 
 void SequenceImageQueue::reportPerformance(Performance* performance) {
   reader->reportPerformance(performance);
+  performance->prefetchedFrames += static_cast<int64_t>(prefetchedFrames.size());
 }
 }  // namespace pag
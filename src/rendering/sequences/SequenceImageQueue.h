@@ -19,6 +19,7 @@
 #pragma once
 
 #include "SequenceInfo.h"
+#include "SequencePrefetcher.h"
 #include "SequenceReader.h"
 #include "pag/file.h"
 #include "pag/pag.h"
@@ -29,6 +30,8 @@ class SequenceImageQueue {
   static std::unique_ptr<SequenceImageQueue> MakeFrom(std::shared_ptr<SequenceInfo> sequence,
                                                       PAGLayer* pagLayer, bool useDiskCache);
 
+  ~SequenceImageQueue();
+
   /**
    * Prepares the image of the next frame.
    */
@@ -59,10 +62,25 @@ class SequenceImageQueue {
   std::shared_ptr<tgfx::Image> currentImage = nullptr;
   std::shared_ptr<tgfx::Image> preparedImage = nullptr;
   bool useDiskCache = false;
+  // Decodes multiple frames ahead in background threads if PAGSequencePrefetch::MaxFrameCount() is
+  // larger than 1, otherwise only the preparedImage is decoded ahead.
+  std::shared_ptr<SequencePrefetcher> prefetcher = nullptr;
+  std::deque<std::shared_ptr<PrefetchedFrame>> prefetchedFrames = {};
+  int prefetchFailures = 0;
+  size_t maxPrefetchCount = 1;
+  size_t maxPrefetchMemory = 0;
 
   SequenceImageQueue(std::shared_ptr<SequenceInfo> sequence, std::shared_ptr<SequenceReader> reader,
                      Frame firstFrame, bool useDiskCache);
 
+  Frame nextFrameOf(Frame frame) const;
+
+  void prefetch(Frame targetFrame);
+
+  std::shared_ptr<tgfx::Image> getPrefetchedImage(Frame targetFrame);
+
+  void dropPrefetchedFramesBefore(Frame targetFrame);
+
   friend class RenderCache;
 };
 }  // namespace pag
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SequencePrefetcher.h"
+#include "tgfx/utils/Task.h"
+
+namespace pag {
+std::shared_ptr<SequencePrefetcher> SequencePrefetcher::Make(
+    std::shared_ptr<SequenceReader> reader) {
+  if (reader == nullptr) {
+    return nullptr;
+  }
+  auto prefetcher = std::shared_ptr<SequencePrefetcher>(new SequencePrefetcher(std::move(reader)));
+  prefetcher->weakThis = prefetcher;
+  return prefetcher;
+}
+
+SequencePrefetcher::SequencePrefetcher(std::shared_ptr<SequenceReader> reader)
+    : reader(std::move(reader)) {
+}
+
+void SequencePrefetcher::schedule(std::shared_ptr<PrefetchedFrame> frame) {
+  if (frame == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> autoLock(locker);
+    pendingFrames.push_back(frame);
+    if (decoding) {
+      return;
+    }
+    decoding = true;
+  }
+  auto task = tgfx::Task::Run([prefetcher = weakThis.lock()]() {
+    prefetcher->decodePendingFrames();
+  });
+  if (task == nullptr) {
+    decodePendingFrames();
+  }
+}
+
+std::shared_ptr<tgfx::ImageBuffer> SequencePrefetcher::wait(PrefetchedFrame* frame) {
+  std::unique_lock<std::mutex> autoLock(locker);
+  condition.wait(autoLock, [frame] { return frame->finished; });
+  return frame->buffer;
+}
+
+void SequencePrefetcher::cancel() {
+  std::unique_lock<std::mutex> autoLock(locker);
+  pendingFrames.clear();
+  condition.wait(autoLock, [this] { return !decoding; });
+}
+
+void SequencePrefetcher::decodePendingFrames() {
+  std::unique_lock<std::mutex> autoLock(locker);
+  while (!pendingFrames.empty()) {
+    auto frame = pendingFrames.front().lock();
+    pendingFrames.pop_front();
+    if (frame == nullptr) {
+      continue;
+    }
+    autoLock.unlock();
+    auto buffer = reader->readOwnedBuffer(frame->frame);
+    autoLock.lock();
+    frame->buffer = buffer;
+    frame->finished = true;
+    condition.notify_all();
+  }
+  decoding = false;
+  condition.notify_all();
+}
+}  // namespace pag
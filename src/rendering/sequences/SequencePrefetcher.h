@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "rendering/sequences/SequenceReader.h"
+
+namespace pag {
+// Prefetching is disabled after this number of frames in a row fail to decode ahead.
+static constexpr int MAX_PREFETCH_FAILURES = 3;
+
+/**
+ * A frame of a sequence that is decoded ahead by a SequencePrefetcher.
+ */
+struct PrefetchedFrame {
+  explicit PrefetchedFrame(Frame frame) : frame(frame) {
+  }
+
+  Frame frame = -1;
+  bool finished = false;
+  std::shared_ptr<tgfx::ImageBuffer> buffer = nullptr;
+};
+
+/**
+ * SequencePrefetcher decodes the frames of a sequence in background threads. The frames are decoded
+ * one after another in the order they are scheduled, so that video decoders never need to seek
+ * backward.
+ */
+class SequencePrefetcher {
+ public:
+  static std::shared_ptr<SequencePrefetcher> Make(std::shared_ptr<SequenceReader> reader);
+
+  /**
+   * Schedules the frame to be decoded after all the frames scheduled before. The frame is skipped
+   * if it is released before its decoding starts.
+   */
+  void schedule(std::shared_ptr<PrefetchedFrame> frame);
+
+  /**
+   * Blocks until the specified frame is decoded and returns its buffer. Returns nullptr if the
+   * frame fails to decode.
+   */
+  std::shared_ptr<tgfx::ImageBuffer> wait(PrefetchedFrame* frame);
+
+  /**
+   * Drops all the frames that are not decoded yet and blocks until the frame being decoded
+   * finishes, so that the reader can be used by the caller directly afterwards.
+   */
+  void cancel();
+
+ private:
+  std::mutex locker = {};
+  std::condition_variable condition = {};
+  std::weak_ptr<SequencePrefetcher> weakThis;
+  std::shared_ptr<SequenceReader> reader = nullptr;
+  std::deque<std::weak_ptr<PrefetchedFrame>> pendingFrames = {};
+  bool decoding = false;
+
+  explicit SequencePrefetcher(std::shared_ptr<SequenceReader> reader);
+
+  void decodePendingFrames();
+};
+}  // namespace pag
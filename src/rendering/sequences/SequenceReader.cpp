@@ -30,6 +30,13 @@ std::shared_ptr<tgfx::ImageBuffer> SequenceReader::readBuffer(Frame targetFrame)
   return buffer;
 }
 
+std::shared_ptr<tgfx::ImageBuffer> SequenceReader::readOwnedBuffer(Frame targetFrame) {
+  tgfx::Clock clock = {};
+  auto buffer = onMakeOwnedBuffer(targetFrame);
+  decodingTime += clock.measure();
+  return buffer;
+}
+
 void SequenceReader::reportPerformance(Performance* performance) {
   if (decodingTime > 0) {
     onReportPerformance(performance, decodingTime);
@@ -44,6 +44,13 @@ class SequenceReader {
    */
   std::shared_ptr<tgfx::ImageBuffer> readBuffer(Frame targetFrame);
 
+  /**
+   * Decodes the specified target frame immediately and returns a decoded image buffer that does not
+   * share memory with the reader, so it remains valid while the following frames are decoded.
+   * Returns nullptr if the reader can not make such buffers.
+   */
+  std::shared_ptr<tgfx::ImageBuffer> readOwnedBuffer(Frame targetFrame);
+
   void reportPerformance(Performance* performance);
 
  protected:
@@ -52,6 +59,14 @@ class SequenceReader {
    */
   virtual std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) = 0;
 
+  /**
+   * Return the decoded ImageBuffer of the specified frame that does not share memory with the
+   * reader. The default implementation returns nullptr.
+   */
+  virtual std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame) {
+    return nullptr;
+  }
+
   /**
    * Reports the decoding performance data.
    */
@@ -19,6 +19,7 @@
 #include "VideoReader.h"
 #include "base/utils/TimeUtil.h"
 #include "platform/Platform.h"
+#include "rendering/video/VideoDecoderPool.h"
 #include "tgfx/utils/Clock.h"
 
 namespace pag {
@@ -39,6 +40,7 @@ VideoReader::VideoReader(std::unique_ptr<VideoDemuxer> videoDemuxer)
 }
 
 VideoReader::~VideoReader() {
+  recycleVideoDecoder();
   destroyVideoDecoder();
   delete demuxer;
 }
@@ -46,6 +48,19 @@ VideoReader::~VideoReader() {
 std::shared_ptr<tgfx::ImageBuffer> VideoReader::onMakeBuffer(Frame targetFrame) {
   // Need a locker here in case there are other threads are decoding at the same time.
   std::lock_guard<std::mutex> autoLock(locker);
+  return decodeBuffer(targetFrame);
+}
+
+std::shared_ptr<tgfx::ImageBuffer> VideoReader::onMakeOwnedBuffer(Frame targetFrame) {
+  std::lock_guard<std::mutex> autoLock(locker);
+  if (decodeBuffer(targetFrame) == nullptr) {
+    return nullptr;
+  }
+  // The decoded frame refers to the memory of the decoder, which is overwritten by the next frame.
+  return videoDecoder->onRenderFrameCopy();
+}
+
+std::shared_ptr<tgfx::ImageBuffer> VideoReader::decodeBuffer(Frame targetFrame) {
   auto targetTime = FrameToTime(targetFrame, frameRate);
   auto sampleTime = demuxer->getSampleTimeAt(targetTime);
   if (sampleTime == currentRenderedTime) {
@@ -84,6 +99,10 @@ std::shared_ptr<tgfx::ImageBuffer> VideoReader::onMakeBuffer(Frame targetFrame)
 }
 
 void VideoReader::onReportPerformance(Performance* performance, int64_t decodingTime) {
+  performance->pooledDecoderHits += pooledDecoderHits;
+  performance->pooledDecoderMisses += pooledDecoderMisses;
+  pooledDecoderHits = 0;
+  pooledDecoderMisses = 0;
   if (videoDecoder == nullptr) {
     return;
   }
@@ -172,8 +191,23 @@ void VideoReader::destroyVideoDecoder() {
   }
   delete videoDecoder;
   videoDecoder = nullptr;
+  decoderFactory = nullptr;
+  lastBuffer = nullptr;
+  currentRenderedTime = INT64_MIN;
+  resetParams();
+}
+
+void VideoReader::recycleVideoDecoder() {
+  if (videoDecoder == nullptr) {
+    return;
+  }
+  // Releases the last frame first, since a decoder is only reusable if no frame refers to it.
   lastBuffer = nullptr;
   currentRenderedTime = INT64_MIN;
+  VideoDecoderPool::Recycle(decoderFactory, demuxer->getFormat(),
+                            std::unique_ptr<VideoDecoder>(videoDecoder));
+  videoDecoder = nullptr;
+  decoderFactory = nullptr;
   resetParams();
 }
 
@@ -193,9 +227,19 @@ std::unique_ptr<VideoDecoder> VideoReader::makeVideoDecoder() {
       factoryIndex++;
       continue;
     }
+    auto decoder = VideoDecoderPool::Obtain(factory, demuxer->getFormat());
+    if (decoder != nullptr) {
+      pooledDecoderHits++;
+      decoderFactory = factory;
+      return decoder;
+    }
+    if (VideoDecoderPool::Accepts(factory)) {
+      pooledDecoderMisses++;
+    }
     tgfx::Clock clock = {};
-    auto decoder = factory->createDecoder(demuxer->getFormat());
+    decoder = factory->createDecoder(demuxer->getFormat());
     if (decoder != nullptr) {
+      decoderFactory = factory;
       if (decoder->isHardwareBacked()) {
         hardDecodingInitialTime = clock.elapsedTime();
       } else {
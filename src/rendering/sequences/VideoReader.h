@@ -41,6 +41,8 @@ class VideoReader : public SequenceReader {
  protected:
   std::shared_ptr<tgfx::ImageBuffer> onMakeBuffer(Frame targetFrame) override;
 
+  std::shared_ptr<tgfx::ImageBuffer> onMakeOwnedBuffer(Frame targetFrame) override;
+
   void onReportPerformance(Performance* performance, int64_t decodingTime) override;
 
  private:
@@ -50,6 +52,7 @@ class VideoReader : public SequenceReader {
   int factoryIndex = 0;
   bool preferSoftware = false;
   VideoDecoder* videoDecoder = nullptr;
+  const VideoDecoderFactory* decoderFactory = nullptr;
   VideoSample videoSample = {};
   std::shared_ptr<tgfx::ImageBuffer> lastBuffer = nullptr;
   bool outputEndOfStream = false;
@@ -58,9 +61,15 @@ class VideoReader : public SequenceReader {
   int64_t currentRenderedTime = INT64_MIN;
   std::atomic_int64_t hardDecodingInitialTime = 0;
   std::atomic_int64_t softDecodingInitialTime = 0;
+  std::atomic_int64_t pooledDecoderHits = 0;
+  std::atomic_int64_t pooledDecoderMisses = 0;
+
+  std::shared_ptr<tgfx::ImageBuffer> decodeBuffer(Frame targetFrame);
 
   void destroyVideoDecoder();
 
+  void recycleVideoDecoder();
+
   bool checkVideoDecoder();
 
   void resetParams();
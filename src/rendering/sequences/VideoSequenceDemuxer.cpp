@@ -18,6 +18,7 @@
 
 #include "VideoSequenceDemuxer.h"
 #include "base/utils/TimeUtil.h"
+#include "codec/utils/NALUReader.h"
 
 namespace pag {
 VideoSequenceDemuxer::VideoSequenceDemuxer(std::shared_ptr<File> file, VideoSequence* sequence,
@@ -54,8 +55,19 @@ VideoSample VideoSequenceDemuxer::nextSample() {
   }
   VideoSample sample = {};
   auto videoFrame = sequence->frames[sampleIndex];
-  sample.data = videoFrame->fileBytes->data();
-  sample.length = videoFrame->fileBytes->length();
+  if (sequence->hasFrameStartCodes) {
+    sample.data = videoFrame->fileBytes->data();
+    sample.length = videoFrame->fileBytes->length();
+  } else {
+    // The frame refers to the original file bytes, copy it out with the start code written in
+    // front. The video decoders are done with the previous sample once they ask for the next one.
+    auto length = videoFrame->fileBytes->length();
+    sampleBuffer.resize(length + 4);
+    WriteStartCode(sampleBuffer.data(), static_cast<uint32_t>(length));
+    memcpy(sampleBuffer.data() + 4, videoFrame->fileBytes->data(), length);
+    sample.data = sampleBuffer.data();
+    sample.length = sampleBuffer.size();
+  }
   sample.time = FrameToTime(videoFrame->frame, sequence->frameRate);
   maxPTSFrame = std::max(maxPTSFrame, videoFrame->frame);
   sampleIndex++;
@@ -55,6 +55,7 @@ class VideoSequenceDemuxer : public VideoDemuxer {
   PAGFile* pagFile = nullptr;
   VideoFormat format = {};
   std::vector<Frame> keyframes = {};
+  std::vector<uint8_t> sampleBuffer = {};
 
   bool staticContent() const override {
     return sequence->composition->staticContent();
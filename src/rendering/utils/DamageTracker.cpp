@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DamageTracker.h"
+#include "base/utils/TGFXCast.h"
+#include "pag/file.h"
+#include "rendering/caches/LayerCache.h"
+#include "rendering/editing/ImageReplacement.h"
+#include "rendering/filters/FilterModifier.h"
+#include "rendering/layers/PAGStage.h"
+#include "rendering/utils/Transform.h"
+
+namespace pag {
+void DamageTracker::update(PAGStage* stage) {
+  std::unordered_map<ID, LayerState> states = {};
+  ID previousID = 0;
+  collectLayers(stage, tgfx::Matrix::I(), 1.0f, nullptr, &previousID, &states);
+  for (auto& item : layerStates) {
+    if (states.count(item.first) == 0) {
+      // The layer has been removed or hidden since the last update.
+      _damagedBounds.join(item.second.bounds);
+    }
+  }
+  layerStates = std::move(states);
+}
+
+void DamageTracker::clearDamage() {
+  _damagedBounds.setEmpty();
+  _fullyDamaged = false;
+}
+
+bool DamageTracker::DrawsChildrenDirectly(PAGLayer* pagLayer) {
+  // Only a vector composition drawn without any offscreen pass, such as filters, masks or a track
+  // matte, leaves the pixels of its children untouched, so that the children can be tracked one by
+  // one. Any other layer is tracked as a whole.
+  if (pagLayer->layer->type() != LayerType::PreCompose) {
+    return false;
+  }
+  auto composition = static_cast<PreComposeLayer*>(pagLayer->layer)->composition;
+  if (composition->type() != CompositionType::Vector) {
+    return false;
+  }
+  if (!pagLayer->contentModified() && pagLayer->layerCache->contentStatic()) {
+    // The composition is drawn from the cached content.
+    return false;
+  }
+  return pagLayer->_trackMatteLayer == nullptr && pagLayer->layer->masks.empty() &&
+         FilterModifier::Make(pagLayer) == nullptr;
+}
+
+bool DamageTracker::ContentFrameChanged(PAGLayer* pagLayer, Frame lastContentFrame) {
+  if (pagLayer->contentFrame == lastContentFrame) {
+    return false;
+  }
+  if (pagLayer->layer->type() == LayerType::PreCompose && pagLayer->contentModified()) {
+    // The static time ranges of a modified composition no longer describe its children.
+    return true;
+  }
+  return pagLayer->layerCache->checkFrameChanged(pagLayer->contentFrame, lastContentFrame);
+}
+
+bool DamageTracker::LayerChanged(PAGLayer* pagLayer, const LayerState& current,
+                                 const LayerState& last) {
+  if (current.previousID != last.previousID || current.contentVersion != last.contentVersion ||
+      current.replacementFrame != last.replacementFrame || current.alpha != last.alpha ||
+      current.matrix != last.matrix || current.bounds != last.bounds) {
+    return true;
+  }
+  if (ContentFrameChanged(pagLayer, last.contentFrame)) {
+    return true;
+  }
+  auto trackMatteLayer = pagLayer->_trackMatteLayer.get();
+  return trackMatteLayer != nullptr && ContentFrameChanged(trackMatteLayer, last.trackMatteFrame);
+}
+
+void DamageTracker::collectLayers(PAGComposition* composition, const tgfx::Matrix& matrix,
+                                  float alpha, const tgfx::Rect* clipBounds, ID* previousID,
+                                  std::unordered_map<ID, LayerState>* states) {
+  tgfx::Rect compositionClip = {};
+  if (composition->hasClip()) {
+    compositionClip = tgfx::Rect::MakeWH(composition->_width, composition->_height);
+    matrix.mapRect(&compositionClip);
+    if (clipBounds != nullptr && !compositionClip.intersect(*clipBounds)) {
+      compositionClip.setEmpty();
+    }
+    clipBounds = &compositionClip;
+  }
+  for (auto& childLayer : composition->layers) {
+    if (!childLayer->layerVisible) {
+      continue;
+    }
+    auto pagLayer = childLayer.get();
+    if (!DrawsChildrenDirectly(pagLayer)) {
+      collectLayer(pagLayer, matrix, alpha, clipBounds, previousID, states);
+      continue;
+    }
+    Transform transform = {};
+    if (!pagLayer->getTransform(&transform)) {
+      continue;
+    }
+    transform.matrix.postConcat(matrix);
+    collectLayers(static_cast<PAGComposition*>(pagLayer), transform.matrix,
+                  alpha * transform.alpha, clipBounds, previousID, states);
+  }
+}
+
+void DamageTracker::collectLayer(PAGLayer* pagLayer, const tgfx::Matrix& matrix, float alpha,
+                                 const tgfx::Rect* clipBounds, ID* previousID,
+                                 std::unordered_map<ID, LayerState>* states) {
+  LayerState state = {};
+  // Keeps the previous layer in the drawing order, so that a layer moved above or below others is
+  // also damaged.
+  state.previousID = *previousID;
+  state.contentFrame = pagLayer->contentFrame;
+  state.contentVersion = pagLayer->contentVersion;
+  state.matrix = ToTGFX(pagLayer->layerMatrix);
+  state.matrix.postConcat(matrix);
+  state.alpha = alpha * pagLayer->layerAlpha;
+  if (pagLayer->_trackMatteLayer != nullptr) {
+    state.trackMatteFrame = pagLayer->_trackMatteLayer->contentFrame;
+  }
+  if (pagLayer->layer->type() == LayerType::Image) {
+    auto replacement = static_cast<PAGImageLayer*>(pagLayer)->replacement;
+    if (replacement != nullptr) {
+      state.replacementFrame = replacement->contentFrame;
+    }
+  }
+  PAGComposition::MeasureChildLayer(&state.bounds, pagLayer);
+  matrix.mapRect(&state.bounds);
+  if (clipBounds != nullptr && !state.bounds.intersect(*clipBounds)) {
+    state.bounds.setEmpty();
+  }
+  auto id = pagLayer->_uniqueID;
+  *previousID = id;
+  auto result = layerStates.find(id);
+  if (result == layerStates.end()) {
+    _damagedBounds.join(state.bounds);
+  } else if (LayerChanged(pagLayer, state, result->second)) {
+    _damagedBounds.join(result->second.bounds);
+    _damagedBounds.join(state.bounds);
+  }
+  (*states)[id] = state;
+}
+}  // namespace pag
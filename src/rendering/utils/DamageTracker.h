@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <unordered_map>
+#include "pag/pag.h"
+#include "tgfx/core/Matrix.h"
+#include "tgfx/core/Rect.h"
+
+namespace pag {
+/**
+ * DamageTracker compares the layer tree of a PAGStage with the one it saw in the last update and
+ * collects the region of the stage that has changed since then. It relies on the static time
+ * ranges of the layer caches and the content versions of the layers, so nothing is rendered to
+ * find the changes.
+ */
+class DamageTracker {
+ public:
+  /**
+   * Compares the current state of the stage with the one in the last update and adds the changed
+   * region to the damaged bounds.
+   */
+  void update(PAGStage* stage);
+
+  /**
+   * Returns true if the whole stage needs to be redrawn, which is the case until clearDamage() is
+   * called for the first time.
+   */
+  bool fullyDamaged() const {
+    return _fullyDamaged;
+  }
+
+  /**
+   * Returns the region changed since the last call to clearDamage(), in the coordinate of the
+   * stage.
+   */
+  const tgfx::Rect& damagedBounds() const {
+    return _damagedBounds;
+  }
+
+  /**
+   * Clears the damaged region. Called once the damaged region has been redrawn.
+   */
+  void clearDamage();
+
+ private:
+  struct LayerState {
+    ID previousID = 0;
+    Frame contentFrame = 0;
+    Frame trackMatteFrame = 0;
+    Frame replacementFrame = 0;
+    uint32_t contentVersion = 0;
+    tgfx::Matrix matrix = tgfx::Matrix::I();
+    float alpha = 1.0f;
+    tgfx::Rect bounds = tgfx::Rect::MakeEmpty();
+  };
+
+  std::unordered_map<ID, LayerState> layerStates = {};
+  tgfx::Rect _damagedBounds = tgfx::Rect::MakeEmpty();
+  bool _fullyDamaged = true;
+
+  static bool DrawsChildrenDirectly(PAGLayer* pagLayer);
+  static bool ContentFrameChanged(PAGLayer* pagLayer, Frame lastContentFrame);
+  static bool LayerChanged(PAGLayer* pagLayer, const LayerState& current, const LayerState& last);
+
+  void collectLayers(PAGComposition* composition, const tgfx::Matrix& matrix, float alpha,
+                     const tgfx::Rect* clipBounds, ID* previousID,
+                     std::unordered_map<ID, LayerState>* states);
+  void collectLayer(PAGLayer* pagLayer, const tgfx::Matrix& matrix, float alpha,
+                    const tgfx::Rect* clipBounds, ID* previousID,
+                    std::unordered_map<ID, LayerState>* states);
+};
+}  // namespace pag
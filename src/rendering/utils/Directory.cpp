@@ -120,7 +120,8 @@ bool Directory::CreateRecursively(const std::string& folder) {
 
 void Directory::VisitFiles(const std::string& folder,
                            std::function<void(const std::string&, size_t)> callback) {
-  for (const auto& entry : std::filesystem::directory_iterator(folder)) {
+  std::error_code errorCode = {};
+  for (const auto& entry : std::filesystem::directory_iterator(folder, errorCode)) {
     if (entry.is_regular_file()) {
       std::string str = entry.path().filename().string();
       if (str == "." || str == "..") {
@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "FrameCodec.h"
+#include "rendering/utils/LZ4Decoder.h"
+#include "rendering/utils/LZ4Encoder.h"
+#ifdef PAG_USE_ZSTD
+#include "zstd.h"
+#endif
+
+namespace pag {
+class LZ4FrameCodec : public FrameCodec {
+ public:
+  CompressionType type() const override {
+    return FrameCodec::DefaultType();
+  }
+
+  size_t maxEncodedSize(size_t inputSize) const override {
+    return LZ4Encoder::GetMaxOutputSize(inputSize);
+  }
+
+  size_t encode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                size_t srcSize) override {
+    if (encoder == nullptr) {
+      encoder = LZ4Encoder::Make();
+    }
+    return encoder->encode(dstBuffer, dstSize, srcBuffer, srcSize);
+  }
+
+  size_t decode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                size_t srcSize) override {
+    if (decoder == nullptr) {
+      decoder = LZ4Decoder::Make();
+    }
+    return decoder->decode(dstBuffer, dstSize, srcBuffer, srcSize);
+  }
+
+ private:
+  std::unique_ptr<LZ4Encoder> encoder = nullptr;
+  std::unique_ptr<LZ4Decoder> decoder = nullptr;
+};
+
+#ifdef PAG_USE_ZSTD
+class ZSTDFrameCodec : public FrameCodec {
+ public:
+  ~ZSTDFrameCodec() override {
+    ZSTD_freeCCtx(compressContext);
+    ZSTD_freeDCtx(decompressContext);
+  }
+
+  CompressionType type() const override {
+    return CompressionType::ZSTD;
+  }
+
+  size_t maxEncodedSize(size_t inputSize) const override {
+    return ZSTD_compressBound(inputSize);
+  }
+
+  size_t encode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                size_t srcSize) override {
+    if (compressContext == nullptr) {
+      compressContext = ZSTD_createCCtx();
+      if (compressContext == nullptr) {
+        return 0;
+      }
+    }
+    auto result = ZSTD_compressCCtx(compressContext, dstBuffer, dstSize, srcBuffer, srcSize,
+                                    CompressionLevel);
+    return ZSTD_isError(result) ? 0 : result;
+  }
+
+  size_t decode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                size_t srcSize) override {
+    if (decompressContext == nullptr) {
+      decompressContext = ZSTD_createDCtx();
+      if (decompressContext == nullptr) {
+        return 0;
+      }
+    }
+    auto result = ZSTD_decompressDCtx(decompressContext, dstBuffer, dstSize, srcBuffer, srcSize);
+    return ZSTD_isError(result) ? 0 : result;
+  }
+
+ private:
+  // Level 3 is the default level of zstd, it is still fast enough to keep up with rendering.
+  static constexpr int CompressionLevel = 3;
+  ZSTD_CCtx* compressContext = nullptr;
+  ZSTD_DCtx* decompressContext = nullptr;
+};
+#endif
+
+CompressionType FrameCodec::DefaultType() {
+#ifdef __APPLE__
+  return CompressionType::LZ4_APPLE;
+#else
+  return CompressionType::LZ4;
+#endif
+}
+
+std::unique_ptr<FrameCodec> FrameCodec::Make(CompressionType type) {
+  if (type == DefaultType()) {
+    return std::make_unique<LZ4FrameCodec>();
+  }
+#ifdef PAG_USE_ZSTD
+  if (type == CompressionType::ZSTD) {
+    return std::make_unique<ZSTDFrameCodec>();
+  }
+#endif
+  return nullptr;
+}
+}  // namespace pag
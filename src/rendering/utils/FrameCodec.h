@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pag {
+/**
+ * The compression types stored in the head of sequence files, the values must not be changed.
+ */
+enum class CompressionType {
+  LZ4 = 1,
+  LZ4_APPLE = 2,
+  ZSTD = 3,
+};
+
+/**
+ * FrameCodec compresses and decompresses the pixels of image frames. A FrameCodec is not thread
+ * safe, each thread should use its own instance.
+ */
+class FrameCodec {
+ public:
+  /**
+   * Returns the default compression type of current platform.
+   */
+  static CompressionType DefaultType();
+
+  /**
+   * Creates a FrameCodec of the specified type. Returns nullptr if the type is not supported on
+   * current platform.
+   */
+  static std::unique_ptr<FrameCodec> Make(CompressionType type);
+
+  virtual ~FrameCodec() = default;
+
+  /**
+   * Returns the compression type of this codec.
+   */
+  virtual CompressionType type() const = 0;
+
+  /**
+   * Returns the maximum size that the compression may output in a "worst case" scenario.
+   */
+  virtual size_t maxEncodedSize(size_t inputSize) const = 0;
+
+  /**
+   * Compresses the contents of a source buffer into a destination buffer. Returns the number of
+   * bytes written to the destination buffer, or 0 if an error occurs.
+   */
+  virtual size_t encode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                        size_t srcSize) = 0;
+
+  /**
+   * Decompresses the contents of a source buffer into a destination buffer. Returns the number of
+   * bytes written to the destination buffer.
+   */
+  virtual size_t decode(uint8_t* dstBuffer, size_t dstSize, const uint8_t* srcBuffer,
+                        size_t srcSize) = 0;
+};
+}  // namespace pag
@@ -18,6 +18,7 @@
 
 #include "MemoryCalculator.h"
 #include "base/utils/Log.h"
+#include "rendering/caches/FrameCache.h"
 #include "rendering/caches/LayerCache.h"
 
 namespace pag {
@@ -314,6 +315,7 @@ int64_t CalculateGraphicsMemory(std::shared_ptr<File> file) {
   if (file == nullptr) {
     return 0;
   }
+  FrameCachePins framePins = {};
   auto rootLayer = file->getRootLayer();
   std::unordered_map<void*, tgfx::Point> resourcesMaxScaleMap;
   std::unordered_map<void*, std::vector<TimeRange>*> resourcesTimeRangesMap;
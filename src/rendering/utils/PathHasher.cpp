@@ -17,9 +17,24 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "PathHasher.h"
+#include <functional>
 
 namespace pag {
+static void HashCombine(size_t* hash, size_t value) {
+  *hash ^= value + 0x9e3779b9 + (*hash << 6) + (*hash >> 2);
+}
+
 size_t PathHasher::operator()(const tgfx::Path& path) const {
-  return path.countPoints();
+  // Paths with equal hashes still need to be compared by operator==().
+  std::hash<float> floatHasher = {};
+  auto hash = static_cast<size_t>(path.countPoints());
+  HashCombine(&hash, static_cast<size_t>(path.countVerbs()));
+  HashCombine(&hash, static_cast<size_t>(path.getFillType()));
+  auto bounds = path.getBounds();
+  HashCombine(&hash, floatHasher(bounds.left));
+  HashCombine(&hash, floatHasher(bounds.top));
+  HashCombine(&hash, floatHasher(bounds.right));
+  HashCombine(&hash, floatHasher(bounds.bottom));
+  return hash;
 }
 }  // namespace pag
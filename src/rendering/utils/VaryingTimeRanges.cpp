@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VaryingTimeRanges.h"
+#include <algorithm>
+#include "base/utils/TimeUtil.h"
+#include "rendering/caches/LayerCache.h"
+
+namespace pag {
+void VaryingTimeRanges::addLayer(LayerCache* layerCache, Frame startFrame, float frameRate,
+                                 int64_t timeOffset) {
+  auto layerIndex = layers.size();
+  layers.push_back({layerCache, startFrame, frameRate, timeOffset});
+  for (auto& frameRange : *layerCache->getChangeFrameRanges()) {
+    auto startTime = FrameToEarliestTime(frameRange.start + startFrame, frameRate) + timeOffset;
+    auto endTime = FrameToEarliestTime(frameRange.end + startFrame, frameRate) + timeOffset;
+    ranges.push_back({startTime, endTime, layerIndex});
+  }
+  sorted = false;
+}
+
+bool VaryingTimeRanges::changed(int64_t startTime, int64_t endTime) {
+  if (!sorted) {
+    std::sort(ranges.begin(), ranges.end(), [](const VaryingRange& a, const VaryingRange& b) {
+      return a.startTime < b.startTime;
+    });
+    sorted = true;
+  }
+  while (nextRangeIndex < ranges.size() && ranges[nextRangeIndex].startTime <= endTime) {
+    activeRanges.push_back(ranges[nextRangeIndex++]);
+  }
+  // A range ending no later than startTime can not overlap this or any later step.
+  activeRanges.erase(std::remove_if(activeRanges.begin(), activeRanges.end(),
+                                    [startTime](const VaryingRange& range) {
+                                      return range.endTime <= startTime;
+                                    }),
+                     activeRanges.end());
+  // An overlapping range only means that the layer may change, such as a layer with a lower frame
+  // rate, so the layer cache makes the final decision.
+  for (auto& range : activeRanges) {
+    auto& layer = layers[range.layerIndex];
+    auto lastContentFrame =
+        TimeToFrame(startTime - layer.timeOffset, layer.frameRate) - layer.startFrame;
+    auto contentFrame = TimeToFrame(endTime - layer.timeOffset, layer.frameRate) - layer.startFrame;
+    if (layer.layerCache->checkFrameChanged(contentFrame, lastContentFrame)) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace pag
@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "pag/types.h"
+
+namespace pag {
+class LayerCache;
+
+/**
+ * VaryingTimeRanges places the change frames of every layer cache in a layer tree onto one
+ * timeline, so that it can tell whether anything changes between two successive times without
+ * moving the whole layer tree to each of them.
+ */
+class VaryingTimeRanges {
+ public:
+  /**
+   * Adds a layer whose content frames are mapped to the timeline by the specified start frame,
+   * frame rate and time offset.
+   */
+  void addLayer(LayerCache* layerCache, Frame startFrame, float frameRate, int64_t timeOffset);
+
+  /**
+   * Returns true if any of the layers changes when moving from startTime to endTime, which gives
+   * the same result as calling PAGLayer::gotoTime() on the root layer. The calls must be made in
+   * increasing time order, and no layer can be added after the first call.
+   */
+  bool changed(int64_t startTime, int64_t endTime);
+
+ private:
+  struct LayerTimeline {
+    LayerCache* layerCache;
+    Frame startFrame;
+    float frameRate;
+    int64_t timeOffset;
+  };
+
+  struct VaryingRange {
+    int64_t startTime;
+    int64_t endTime;
+    size_t layerIndex;
+  };
+
+  std::vector<LayerTimeline> layers = {};
+  std::vector<VaryingRange> ranges = {};
+  std::vector<VaryingRange> activeRanges = {};
+  size_t nextRangeIndex = 0;
+  bool sorted = false;
+};
+}  // namespace pag
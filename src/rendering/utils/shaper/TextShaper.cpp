@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "TextShaper.h"
+#include "base/utils/USE.h"
 #ifdef PAG_USE_HARFBUZZ
 #include "TextShaperHarfbuzz.h"
 #else
@@ -45,4 +46,68 @@ void TextShaper::PurgeCaches() {
   TextShaperHarfbuzz::PurgeCaches();
 #endif
 }
+
+size_t TextShaper::FontCacheCapacity() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::FontCacheCapacity();
+#else
+  return 0;
+#endif
+}
+
+void TextShaper::SetFontCacheCapacity(size_t capacity) {
+#ifdef PAG_USE_HARFBUZZ
+  TextShaperHarfbuzz::SetFontCacheCapacity(capacity);
+#else
+  USE(capacity);
+#endif
+}
+
+uint64_t TextShaper::FontCacheHitCount() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::FontCacheHitCount();
+#else
+  return 0;
+#endif
+}
+
+uint64_t TextShaper::FontCacheMissCount() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::FontCacheMissCount();
+#else
+  return 0;
+#endif
+}
+
+size_t TextShaper::FontCacheSize() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::FontCacheSize();
+#else
+  return 0;
+#endif
+}
+
+size_t TextShaper::ShapedTextCacheCapacity() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::ShapedTextCacheCapacity();
+#else
+  return 0;
+#endif
+}
+
+size_t TextShaper::ShapedTextCacheSize() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::ShapedTextCacheSize();
+#else
+  return 0;
+#endif
+}
+
+uint64_t TextShaper::ShapedTextCacheHitCount() {
+#ifdef PAG_USE_HARFBUZZ
+  return TextShaperHarfbuzz::ShapedTextCacheHitCount();
+#else
+  return 0;
+#endif
+}
 }  // namespace pag
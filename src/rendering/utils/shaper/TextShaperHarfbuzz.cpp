@@ -19,8 +19,10 @@
 #ifdef PAG_USE_HARFBUZZ
 
 #include "TextShaperHarfbuzz.h"
+#include <algorithm>
+#include <atomic>
 #include <list>
-#include <map>
+#include <unordered_map>
 #include "base/utils/Log.h"
 #include "hb.h"
 #include "rendering/FontManager.h"
@@ -89,60 +91,152 @@ std::shared_ptr<hb_face_t> CreateHBFace(std::shared_ptr<tgfx::Typeface> typeface
   return hbFace;
 }
 
-class HBLockedFontCache {
+/**
+ * A cache of hb_font_t objects keyed by the typeface ID. The fonts are spread over several shards,
+ * each with its own lock and LRU list, so that threads shaping different typefaces rarely wait on
+ * each other. The capacity is split over the shards so that their total never exceeds it, small
+ * capacities use a single shard, and a capacity of 0 disables the cache.
+ */
+class HBFontCache {
  public:
-  HBLockedFontCache(std::list<uint32_t>* lru, std::map<uint32_t, std::shared_ptr<hb_font_t>>* cache,
-                    std::mutex* mutex)
-      : lru(lru), cache(cache), mutex(mutex) {
-    mutex->lock();
-  }
-  HBLockedFontCache(const HBLockedFontCache&) = delete;
-  HBLockedFontCache& operator=(const HBLockedFontCache&) = delete;
-  HBLockedFontCache& operator=(HBLockedFontCache&&) = delete;
-
-  ~HBLockedFontCache() {
-    mutex->unlock();
-  }
+  static constexpr size_t DefaultCapacity = 100;
 
-  std::shared_ptr<hb_font_t> find(uint32_t fontId) {
-    auto iter = std::find(lru->begin(), lru->end(), fontId);
-    if (iter == lru->end()) {
+  std::shared_ptr<hb_font_t> find(uint32_t fontID) {
+    auto& shard = getShard(fontID);
+    std::lock_guard<std::mutex> autoLock(shard.locker);
+    auto result = shard.fonts.find(fontID);
+    if (result == shard.fonts.end()) {
+      misses++;
       return nullptr;
     }
-    lru->erase(iter);
-    lru->push_front(fontId);
-    return (*cache)[fontId];
+    hits++;
+    shard.accessOrder.splice(shard.accessOrder.begin(), shard.accessOrder, result->second.position);
+    return result->second.font;
   }
-  std::shared_ptr<hb_font_t> insert(uint32_t fontId, std::shared_ptr<hb_font_t> hbFont) {
+
+  std::shared_ptr<hb_font_t> insert(uint32_t fontID, std::shared_ptr<hb_font_t> hbFont) {
     if (hb_font_get_empty() == hbFont.get()) {
       return nullptr;
     }
-    static const int MaxCacheSize = 100;
-    cache->insert(std::make_pair(fontId, std::move(hbFont)));
-    lru->push_front(fontId);
-    while (lru->size() > MaxCacheSize) {
-      auto id = lru->back();
-      lru->pop_back();
-      cache->erase(id);
+    auto index = shardIndex(fontID, _capacity);
+    auto& shard = shards[index];
+    std::lock_guard<std::mutex> autoLock(shard.locker);
+    auto result = shard.fonts.find(fontID);
+    if (result != shard.fonts.end()) {
+      // Another thread has created the same font in the meantime.
+      return result->second.font;
+    }
+    // Checks against the capacity the shard was trimmed to, in case it was changed meanwhile.
+    if (shardIndex(fontID, shard.capacity) != index) {
+      return hbFont;
+    }
+    auto maxCount = shardCapacity(index, shard.capacity);
+    if (maxCount == 0) {
+      return hbFont;
+    }
+    shard.accessOrder.push_front(fontID);
+    shard.fonts[fontID] = {hbFont, shard.accessOrder.begin()};
+    trimShard(shard, maxCount);
+    return hbFont;
+  }
+
+  size_t capacity() const {
+    return _capacity;
+  }
+
+  void setCapacity(size_t value) {
+    _capacity = value;
+    for (size_t index = 0; index < ShardCount; index++) {
+      auto& shard = shards[index];
+      std::lock_guard<std::mutex> autoLock(shard.locker);
+      if (shardsInUse(value) != shardsInUse(shard.capacity)) {
+        // The fonts are mapped to different shards now, drop the ones kept by the old mapping.
+        trimShard(shard, 0);
+      }
+      shard.capacity = value;
+      trimShard(shard, shardCapacity(index, value));
+    }
+  }
+
+  uint64_t hitCount() const {
+    return hits;
+  }
+
+  uint64_t missCount() const {
+    return misses;
+  }
+
+  size_t size() {
+    size_t count = 0;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> autoLock(shard.locker);
+      count += shard.fonts.size();
     }
-    return (*cache)[fontId];
+    return count;
   }
-  void reset() {
-    lru->clear();
-    cache->clear();
+
+  void clear() {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> autoLock(shard.locker);
+      shard.fonts.clear();
+      shard.accessOrder.clear();
+    }
   }
 
  private:
-  std::list<uint32_t>* lru;
-  std::map<uint32_t, std::shared_ptr<hb_font_t>>* cache;
-  std::mutex* mutex;
+  static constexpr size_t ShardCount = 8;
+  // The cache is only sharded if every shard can keep at least this number of fonts.
+  static constexpr size_t MinShardCapacity = 8;
+
+  struct Entry {
+    std::shared_ptr<hb_font_t> font;
+    std::list<uint32_t>::iterator position;
+  };
+
+  struct Shard {
+    std::mutex locker = {};
+    // The cache capacity this shard was last trimmed to.
+    size_t capacity = DefaultCapacity;
+    std::unordered_map<uint32_t, Entry> fonts;
+    std::list<uint32_t> accessOrder;
+  };
+
+  Shard shards[ShardCount];
+  std::atomic<size_t> _capacity = {DefaultCapacity};
+  std::atomic<uint64_t> hits = {0};
+  std::atomic<uint64_t> misses = {0};
+
+  static size_t shardsInUse(size_t capacity) {
+    return capacity >= ShardCount * MinShardCapacity ? ShardCount : 1;
+  }
+
+  static size_t shardCapacity(size_t index, size_t capacity) {
+    auto count = shardsInUse(capacity);
+    if (index >= count) {
+      return 0;
+    }
+    return capacity / count + (index < capacity % count ? 1 : 0);
+  }
+
+  static size_t shardIndex(uint32_t fontID, size_t capacity) {
+    return fontID % shardsInUse(capacity);
+  }
+
+  Shard& getShard(uint32_t fontID) {
+    return shards[shardIndex(fontID, _capacity)];
+  }
+
+  static void trimShard(Shard& shard, size_t maxCount) {
+    while (shard.accessOrder.size() > maxCount) {
+      shard.fonts.erase(shard.accessOrder.back());
+      shard.accessOrder.pop_back();
+    }
+  }
 };
 
-static HBLockedFontCache GetHBFontCache() {
-  static auto* HBFontCacheMutex = new std::mutex();
-  static auto* HBFontLRU = new std::list<uint32_t>();
-  static auto* HBFontCache = new std::map<uint32_t, std::shared_ptr<hb_font_t>>();
-  return {HBFontLRU, HBFontCache, HBFontCacheMutex};
+static HBFontCache* GetHBFontCache() {
+  static auto* cache = new HBFontCache();
+  return cache;
 }
 
 static std::shared_ptr<hb_font_t> CreateHBFont(std::shared_ptr<tgfx::Typeface> typeface) {
@@ -150,115 +244,269 @@ static std::shared_ptr<hb_font_t> CreateHBFont(std::shared_ptr<tgfx::Typeface> t
     return nullptr;
   }
   auto cache = GetHBFontCache();
-  auto hbFont = cache.find(typeface->uniqueID());
+  auto hbFont = cache->find(typeface->uniqueID());
   if (hbFont == nullptr) {
     auto hbFace = CreateHBFace(typeface);
     if (hbFace == nullptr) {
       return nullptr;
     }
-    hbFont = cache.insert(typeface->uniqueID(), std::shared_ptr<hb_font_t>(
-                                                    hb_font_create(hbFace.get()), hb_font_destroy));
+    auto font = std::shared_ptr<hb_font_t>(hb_font_create(hbFace.get()), hb_font_destroy);
+    hbFont = cache->insert(typeface->uniqueID(), std::move(font));
   }
   return hbFont;
 }
 
-static std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> Shape(
-    const std::string& text, std::shared_ptr<tgfx::Typeface> typeface) {
+struct HBBufferDeleter {
+  void operator()(hb_buffer_t* buffer) const {
+    hb_buffer_destroy(buffer);
+  }
+};
+
+/**
+ * Returns a HarfBuzz buffer owned by the calling thread, so that shaping does not create and
+ * destroy a buffer for every string.
+ */
+static hb_buffer_t* GetHBBuffer() {
+  static thread_local std::unique_ptr<hb_buffer_t, HBBufferDeleter> hbBuffer = nullptr;
+  if (hbBuffer == nullptr) {
+    hbBuffer.reset(hb_buffer_create());
+    if (!hb_buffer_allocation_successful(hbBuffer.get())) {
+      hbBuffer = nullptr;
+      return nullptr;
+    }
+  }
+  hb_buffer_clear_contents(hbBuffer.get());
+  return hbBuffer.get();
+}
+
+/**
+ * A run of the source text, described by its byte range. A glyphID of 0 means the run has not been
+ * shaped by any typeface yet.
+ */
+struct HBGlyph {
+  uint32_t stringIndex = 0;
+  uint32_t length = 0;
+  tgfx::GlyphID glyphID = 0;
+  std::shared_ptr<tgfx::Typeface> typeface;
+};
+
+/**
+ * Shapes the text[stringIndex, stringIndex + length) range with the given typeface and appends the
+ * resulting glyphs to the output. Returns false if the typeface can not be used for shaping.
+ */
+static bool Shape(const std::string& text, uint32_t stringIndex, uint32_t length,
+                  const std::shared_ptr<tgfx::Typeface>& typeface, std::vector<HBGlyph>* output) {
   auto hbFont = CreateHBFont(typeface);
   if (hbFont == nullptr) {
-    return {};
+    return false;
   }
-
-  auto hbBuffer = std::shared_ptr<hb_buffer_t>(hb_buffer_create(), hb_buffer_destroy);
-  if (!hb_buffer_allocation_successful(hbBuffer.get())) {
-    LOGI("TextShaperHarfbuzz::shape text = %s, alloc harfbuzz(%p) failure", text.c_str(),
-         hbBuffer.get());
-    return {};
+  auto hbBuffer = GetHBBuffer();
+  if (hbBuffer == nullptr) {
+    LOGI("TextShaperHarfbuzz::shape text = %s, alloc harfbuzz buffer failure", text.c_str());
+    return false;
   }
-  hb_buffer_add_utf8(hbBuffer.get(), text.data(), -1, 0, -1);
-  hb_buffer_guess_segment_properties(hbBuffer.get());
-  hb_shape(hbFont.get(), hbBuffer.get(), nullptr, 0);
+  hb_buffer_add_utf8(hbBuffer, text.data() + stringIndex, static_cast<int>(length), 0, -1);
+  hb_buffer_guess_segment_properties(hbBuffer);
+  hb_shape(hbFont.get(), hbBuffer, nullptr, 0);
   unsigned count = 0;
-  auto* infos = hb_buffer_get_glyph_infos(hbBuffer.get(), &count);
-  std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> result;
+  auto* infos = hb_buffer_get_glyph_infos(hbBuffer, &count);
+  auto outputSize = output->size();
   for (unsigned i = 0; i < count; ++i) {
-    auto length = (i + 1 == count ? text.length() : infos[i + 1].cluster) - infos[i].cluster;
-    if (length == 0) {
+    auto glyphLength = (i + 1 == count ? length : infos[i + 1].cluster) - infos[i].cluster;
+    if (glyphLength == 0) {
       continue;
     }
-    result.emplace_back(infos[i].codepoint, infos[i].cluster, length);
+    HBGlyph glyph = {stringIndex + infos[i].cluster, glyphLength, 0, nullptr};
+    if (infos[i].codepoint != 0) {
+      glyph.glyphID = static_cast<tgfx::GlyphID>(infos[i].codepoint);
+      glyph.typeface = typeface;
+    }
+    output->push_back(std::move(glyph));
   }
-  return result;
+  return output->size() > outputSize;
 }
 
-struct HBGlyph {
+/**
+ * Shapes all the unshaped runs in glyphs with the given typeface. Returns true if every run now has
+ * a glyph.
+ */
+static bool Shape(const std::string& text, std::vector<HBGlyph>* glyphs,
+                  const std::shared_ptr<tgfx::Typeface>& typeface, std::vector<HBGlyph>* scratch) {
+  scratch->clear();
+  for (auto& glyph : *glyphs) {
+    if (glyph.glyphID != 0 || !Shape(text, glyph.stringIndex, glyph.length, typeface, scratch)) {
+      scratch->push_back(std::move(glyph));
+    }
+  }
+  std::swap(*glyphs, *scratch);
+  for (auto& glyph : *glyphs) {
+    if (glyph.glyphID == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct ShapedTextKey {
   std::string text;
-  tgfx::GlyphID glyphID = 0;
-  uint32_t stringIndex = 0;
-  std::shared_ptr<tgfx::Typeface> typeface;
+  uint32_t typefaceID = 0;
+  uint32_t fallbackGeneration = 0;
+
+  bool operator==(const ShapedTextKey& other) const {
+    return typefaceID == other.typefaceID && fallbackGeneration == other.fallbackGeneration &&
+           text == other.text;
+  }
 };
 
-static bool Shape(std::list<HBGlyph>& glyphs, std::shared_ptr<tgfx::Typeface> typeface) {
-  bool allShaped = true;
-  for (auto iter = glyphs.begin(); iter != glyphs.end(); ++iter) {
-    if (iter->glyphID == 0) {
-      auto string = iter->text;
-      auto infos = ::pag::Shape(string, typeface);
-      if (infos.empty()) {
-        allShaped = false;
-      } else {
-        auto stringIndex = iter->stringIndex;
-        for (size_t i = 0; i < infos.size(); ++i) {
-          auto [codepoint, cluster, length] = infos[i];
-          HBGlyph glyph;
-          glyph.text = string.substr(cluster, length);
-          glyph.stringIndex = stringIndex + cluster;
-          if (codepoint != 0) {
-            glyph.glyphID = codepoint;
-            glyph.typeface = typeface;
-          } else {
-            allShaped = false;
-          }
-          if (i == 0) {
-            iter = glyphs.erase(iter);
-            iter = glyphs.insert(iter, glyph);
-          } else {
-            iter = glyphs.insert(++iter, glyph);
-          }
-        }
-      }
+struct ShapedTextKeyHasher {
+  size_t operator()(const ShapedTextKey& key) const {
+    auto hash = std::hash<std::string>()(key.text);
+    auto ids = static_cast<uint64_t>(key.typefaceID) << 32 | key.fallbackGeneration;
+    hash ^= std::hash<uint64_t>()(ids) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+};
+
+/**
+ * An LRU cache of shaping results. Templates usually replace the same text on every frame, so most
+ * of the shaping calls can be answered from here.
+ */
+class ShapedTextCache {
+ public:
+  static constexpr size_t MaxCacheSize = 512;
+
+  bool find(const ShapedTextKey& key, PositionedGlyphs* glyphs) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    auto result = entries.find(key);
+    if (result == entries.end()) {
+      return false;
     }
+    hits++;
+    accessOrder.splice(accessOrder.begin(), accessOrder, result->second.position);
+    *glyphs = result->second.glyphs;
+    return true;
+  }
+
+  void insert(ShapedTextKey key, const PositionedGlyphs& glyphs) {
+    std::lock_guard<std::mutex> autoLock(locker);
+    auto result = entries.find(key);
+    if (result != entries.end()) {
+      result->second.glyphs = glyphs;
+      accessOrder.splice(accessOrder.begin(), accessOrder, result->second.position);
+      return;
+    }
+    accessOrder.push_front(key);
+    entries[std::move(key)] = {glyphs, accessOrder.begin()};
+    while (accessOrder.size() > MaxCacheSize) {
+      entries.erase(accessOrder.back());
+      accessOrder.pop_back();
+    }
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> autoLock(locker);
+    entries.clear();
+    accessOrder.clear();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> autoLock(locker);
+    return entries.size();
   }
-  return allShaped;
+
+  uint64_t hitCount() {
+    std::lock_guard<std::mutex> autoLock(locker);
+    return hits;
+  }
+
+ private:
+  struct Entry {
+    PositionedGlyphs glyphs;
+    std::list<ShapedTextKey>::iterator position;
+  };
+
+  std::mutex locker = {};
+  uint64_t hits = 0;
+  std::unordered_map<ShapedTextKey, Entry, ShapedTextKeyHasher> entries;
+  std::list<ShapedTextKey> accessOrder;
+};
+
+static ShapedTextCache* GetShapedTextCache() {
+  static auto* cache = new ShapedTextCache();
+  return cache;
 }
 
 PositionedGlyphs TextShaperHarfbuzz::Shape(const std::string& text,
                                            std::shared_ptr<tgfx::Typeface> face) {
-  std::list<HBGlyph> glyphs;
-  glyphs.emplace_back(HBGlyph{text, {}, 0, nullptr});
+  if (face && face->fontFamily().empty()) {
+    face = nullptr;
+  }
+  ShapedTextKey key = {text, face ? face->uniqueID() : 0, FontManager::GetFallbackGeneration()};
+  PositionedGlyphs positionedGlyphs;
+  auto shapedTextCache = GetShapedTextCache();
+  if (shapedTextCache->find(key, &positionedGlyphs)) {
+    return positionedGlyphs;
+  }
+  std::vector<HBGlyph> glyphs = {{0, static_cast<uint32_t>(text.size()), 0, nullptr}};
+  std::vector<HBGlyph> scratch = {};
   bool allShaped = false;
-  if (face && !face->fontFamily().empty()) {
-    allShaped = ::pag::Shape(glyphs, std::move(face));
+  if (face) {
+    allShaped = ::pag::Shape(text, &glyphs, face, &scratch);
   }
   if (!allShaped) {
     auto typefaces = FontManager::GetFallbackTypefaces();
     for (const auto& faceHolder : typefaces) {
       auto typeface = faceHolder->getTypeface();
-      if (typeface && ::pag::Shape(glyphs, std::move(typeface))) {
+      if (typeface && ::pag::Shape(text, &glyphs, typeface, &scratch)) {
         break;
       }
     }
   }
   std::vector<std::tuple<std::shared_ptr<tgfx::Typeface>, tgfx::GlyphID, uint32_t>> glyphIDs;
-  for (const auto& glyph : glyphs) {
-    glyphIDs.emplace_back(glyph.typeface, glyph.glyphID, glyph.stringIndex);
+  glyphIDs.reserve(glyphs.size());
+  for (auto& glyph : glyphs) {
+    glyphIDs.emplace_back(std::move(glyph.typeface), glyph.glyphID, glyph.stringIndex);
   }
-  return PositionedGlyphs(std::move(glyphIDs));
+  positionedGlyphs = PositionedGlyphs(std::move(glyphIDs));
+  shapedTextCache->insert(std::move(key), positionedGlyphs);
+  return positionedGlyphs;
 }
 
 void TextShaperHarfbuzz::PurgeCaches() {
-  auto cache = GetHBFontCache();
-  cache.reset();
+  GetHBFontCache()->clear();
+  GetShapedTextCache()->clear();
+}
+
+size_t TextShaperHarfbuzz::FontCacheCapacity() {
+  return GetHBFontCache()->capacity();
+}
+
+void TextShaperHarfbuzz::SetFontCacheCapacity(size_t capacity) {
+  GetHBFontCache()->setCapacity(capacity);
+}
+
+uint64_t TextShaperHarfbuzz::FontCacheHitCount() {
+  return GetHBFontCache()->hitCount();
+}
+
+uint64_t TextShaperHarfbuzz::FontCacheMissCount() {
+  return GetHBFontCache()->missCount();
+}
+
+size_t TextShaperHarfbuzz::FontCacheSize() {
+  return GetHBFontCache()->size();
+}
+
+size_t TextShaperHarfbuzz::ShapedTextCacheCapacity() {
+  return ShapedTextCache::MaxCacheSize;
+}
+
+size_t TextShaperHarfbuzz::ShapedTextCacheSize() {
+  return GetShapedTextCache()->size();
+}
+
+uint64_t TextShaperHarfbuzz::ShapedTextCacheHitCount() {
+  return GetShapedTextCache()->hitCount();
 }
 }  // namespace pag
 
@@ -29,6 +29,47 @@ class TextShaperHarfbuzz {
   static PositionedGlyphs Shape(const std::string& text, std::shared_ptr<tgfx::Typeface> typeface);
 
   static void PurgeCaches();
+
+  /**
+   * Returns the maximum number of HarfBuzz fonts kept in the font cache. The default value is 100.
+   */
+  static size_t FontCacheCapacity();
+
+  /**
+   * Sets the maximum number of HarfBuzz fonts kept in the font cache. The cache is disabled if it
+   * is 0.
+   */
+  static void SetFontCacheCapacity(size_t capacity);
+
+  /**
+   * Returns how many font lookups have been answered by the font cache so far.
+   */
+  static uint64_t FontCacheHitCount();
+
+  /**
+   * Returns how many font lookups have missed the font cache so far.
+   */
+  static uint64_t FontCacheMissCount();
+
+  /**
+   * Returns the number of HarfBuzz fonts currently kept in the font cache.
+   */
+  static size_t FontCacheSize();
+
+  /**
+   * Returns the maximum number of shaping results kept in the shaped text cache.
+   */
+  static size_t ShapedTextCacheCapacity();
+
+  /**
+   * Returns the number of shaping results currently kept in the shaped text cache.
+   */
+  static size_t ShapedTextCacheSize();
+
+  /**
+   * Returns how many Shape() calls have been answered by the shaped text cache so far.
+   */
+  static uint64_t ShapedTextCacheHitCount();
 };
 }  // namespace pag
 
@@ -0,0 +1,617 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MP4Demuxer.h"
+#include <algorithm>
+#include <cstring>
+#include "base/utils/Log.h"
+#include "codec/utils/DecodeStream.h"
+#include "codec/utils/NALUReader.h"
+#include "platform/Platform.h"
+
+namespace pag {
+static constexpr uint32_t BoxType(const char name[5]) {
+  return (static_cast<uint32_t>(name[0]) << 24) | (static_cast<uint32_t>(name[1]) << 16) |
+         (static_cast<uint32_t>(name[2]) << 8) | static_cast<uint32_t>(name[3]);
+}
+
+struct MP4RawSample {
+  uint64_t offset = 0;
+  uint32_t size = 0;
+  uint32_t duration = 0;
+  int64_t pts = 0;
+  bool isKeyframe = false;
+};
+
+struct MP4VideoTrack {
+  uint32_t trackID = 0;
+  uint32_t handlerType = 0;
+  uint32_t codecType = 0;
+  uint32_t timescale = 0;
+  int width = 0;
+  int height = 0;
+  int lengthSize = 4;
+  std::vector<std::shared_ptr<tgfx::Data>> headers = {};
+  uint32_t defaultDuration = 0;
+  uint32_t defaultSize = 0;
+  uint32_t defaultFlags = 0;
+  std::vector<std::pair<uint32_t, uint32_t>> timeToSamples = {};
+  std::vector<std::pair<uint32_t, int32_t>> compositionOffsets = {};
+  std::vector<uint32_t> syncSamples = {};
+  bool hasSyncTable = false;
+  std::vector<uint32_t> sampleSizes = {};
+  std::vector<std::pair<uint32_t, uint32_t>> sampleToChunks = {};
+  std::vector<uint64_t> chunkOffsets = {};
+  std::vector<MP4RawSample> samples = {};
+  uint64_t nextDecodeTime = 0;
+  // The length of the whole file, which bounds the number of samples it can hold.
+  uint64_t fileLength = 0;
+};
+
+struct MP4TrackDefaults {
+  uint32_t trackID = 0;
+  uint32_t duration = 0;
+  uint32_t size = 0;
+  uint32_t flags = 0;
+};
+
+static DecodeStream ReadBox(DecodeStream* stream, uint32_t* type) {
+  uint64_t size = stream->readUint32();
+  *type = stream->readUint32();
+  uint64_t headerSize = 8;
+  if (size == 1) {
+    size = stream->readUint64();
+    headerSize = 16;
+  } else if (size == 0) {
+    size = stream->bytesAvailable() + headerSize;
+  }
+  if (stream->context->hasException() || size < headerSize ||
+      size - headerSize > stream->bytesAvailable()) {
+    stream->context->throwException("MP4Demuxer: Invalid box size.");
+    return DecodeStream(stream->context);
+  }
+  auto body = stream->readBytes(static_cast<uint32_t>(size - headerSize));
+  body.setByteOrder(tgfx::ByteOrder::BigEndian);
+  return body;
+}
+
+static bool HasNextBox(DecodeStream* stream) {
+  return stream->bytesAvailable() >= 8 && !stream->context->hasException();
+}
+
+static std::shared_ptr<tgfx::Data> ReadParameterSet(DecodeStream* stream) {
+  auto length = stream->readUint16();
+  auto bytes = stream->readBytes(length);
+  if (length == 0 || length > bytes.length() || stream->context->hasException()) {
+    return nullptr;
+  }
+  std::vector<uint8_t> buffer(length + 4);
+  WriteStartCode(buffer.data(), length);
+  memcpy(buffer.data() + 4, bytes.data(), length);
+  return tgfx::Data::MakeWithCopy(buffer.data(), buffer.size());
+}
+
+static void ParseAVCC(DecodeStream* stream, MP4VideoTrack* track) {
+  // configurationVersion, AVCProfileIndication, profile_compatibility, AVCLevelIndication
+  stream->skip(4);
+  track->lengthSize = (stream->readUint8() & 0x03) + 1;
+  auto numSPS = stream->readUint8() & 0x1F;
+  for (int i = 0; i < numSPS; i++) {
+    auto sps = ReadParameterSet(stream);
+    if (sps != nullptr) {
+      track->headers.push_back(std::move(sps));
+    }
+  }
+  auto numPPS = stream->readUint8();
+  for (int i = 0; i < numPPS; i++) {
+    auto pps = ReadParameterSet(stream);
+    if (pps != nullptr) {
+      track->headers.push_back(std::move(pps));
+    }
+  }
+}
+
+static void ParseSTSD(DecodeStream* stream, MP4VideoTrack* track) {
+  stream->skip(4);
+  auto entryCount = stream->readUint32();
+  if (entryCount == 0 || !HasNextBox(stream)) {
+    return;
+  }
+  // Only the first sample description is used.
+  auto entry = ReadBox(stream, &track->codecType);
+  if (track->codecType != BoxType("avc1") && track->codecType != BoxType("avc3")) {
+    return;
+  }
+  // The fields of VisualSampleEntry before width and height.
+  entry.skip(24);
+  track->width = entry.readUint16();
+  track->height = entry.readUint16();
+  // The remaining fields of VisualSampleEntry, 78 bytes in total.
+  entry.skip(50);
+  while (HasNextBox(&entry)) {
+    uint32_t type = 0;
+    auto body = ReadBox(&entry, &type);
+    if (type == BoxType("avcC")) {
+      ParseAVCC(&body, track);
+    }
+  }
+}
+
+static uint32_t SampleTableEntrySize(uint32_t type) {
+  if (type == BoxType("stts") || type == BoxType("ctts") || type == BoxType("co64")) {
+    return 8;
+  }
+  if (type == BoxType("stsc")) {
+    return 12;
+  }
+  return 4;
+}
+
+static void ParseSampleTable(DecodeStream* stream, uint32_t type, MP4VideoTrack* track) {
+  // version and flags.
+  stream->skip(4);
+  if (type == BoxType("stsz")) {
+    auto sampleSize = stream->readUint32();
+    auto count = stream->readUint32();
+    // The count comes from the file, so it must be backed by either the table entries or the
+    // sample data before anything is allocated for it.
+    if (sampleSize != 0 ? static_cast<uint64_t>(count) * sampleSize > track->fileLength
+                        : count > stream->bytesAvailable() / 4) {
+      stream->context->throwException("MP4Demuxer: Invalid sample count.");
+      return;
+    }
+    track->sampleSizes.reserve(count);
+    for (uint32_t i = 0; i < count && !stream->context->hasException(); i++) {
+      track->sampleSizes.push_back(sampleSize != 0 ? sampleSize : stream->readUint32());
+    }
+    return;
+  }
+  auto count = stream->readUint32();
+  if (count > stream->bytesAvailable() / SampleTableEntrySize(type)) {
+    stream->context->throwException("MP4Demuxer: Invalid sample table.");
+    return;
+  }
+  for (uint32_t i = 0; i < count && !stream->context->hasException(); i++) {
+    if (type == BoxType("stts")) {
+      auto sampleCount = stream->readUint32();
+      track->timeToSamples.emplace_back(sampleCount, stream->readUint32());
+    } else if (type == BoxType("ctts")) {
+      auto sampleCount = stream->readUint32();
+      // The offsets are unsigned in version 0, but negative offsets are written by some muxers.
+      track->compositionOffsets.emplace_back(sampleCount, stream->readInt32());
+    } else if (type == BoxType("stss")) {
+      track->syncSamples.push_back(stream->readUint32());
+    } else if (type == BoxType("stsc")) {
+      auto firstChunk = stream->readUint32();
+      track->sampleToChunks.emplace_back(firstChunk, stream->readUint32());
+      stream->skip(4);
+    } else if (type == BoxType("stco")) {
+      track->chunkOffsets.push_back(stream->readUint32());
+    } else if (type == BoxType("co64")) {
+      track->chunkOffsets.push_back(stream->readUint64());
+    }
+  }
+  if (type == BoxType("stss")) {
+    track->hasSyncTable = true;
+  }
+}
+
+static void ParseTrackBoxes(DecodeStream* stream, MP4VideoTrack* track) {
+  while (HasNextBox(stream)) {
+    uint32_t type = 0;
+    auto body = ReadBox(stream, &type);
+    if (type == BoxType("mdia") || type == BoxType("minf") || type == BoxType("stbl")) {
+      ParseTrackBoxes(&body, track);
+    } else if (type == BoxType("tkhd")) {
+      auto version = body.readUint8();
+      // flags, creation_time and modification_time.
+      body.skip(version == 1 ? 19 : 11);
+      track->trackID = body.readUint32();
+    } else if (type == BoxType("mdhd")) {
+      auto version = body.readUint8();
+      body.skip(version == 1 ? 19 : 11);
+      track->timescale = body.readUint32();
+    } else if (type == BoxType("hdlr")) {
+      // version, flags and pre_defined.
+      body.skip(8);
+      track->handlerType = body.readUint32();
+    } else if (type == BoxType("stsd")) {
+      ParseSTSD(&body, track);
+    } else if (type == BoxType("stts") || type == BoxType("ctts") || type == BoxType("stss") ||
+               type == BoxType("stsz") || type == BoxType("stsc") || type == BoxType("stco") ||
+               type == BoxType("co64")) {
+      ParseSampleTable(&body, type, track);
+    }
+  }
+}
+
+static void BuildTableSamples(MP4VideoTrack* track) {
+  auto& sampleSizes = track->sampleSizes;
+  if (sampleSizes.empty()) {
+    return;
+  }
+  auto& samples = track->samples;
+  samples.resize(sampleSizes.size());
+  size_t index = 0;
+  auto& sampleToChunks = track->sampleToChunks;
+  for (size_t i = 0; i < sampleToChunks.size() && index < samples.size(); i++) {
+    auto firstChunk = std::max(sampleToChunks[i].first, 1u);
+    auto lastChunk = i + 1 < sampleToChunks.size()
+                         ? sampleToChunks[i + 1].first - 1
+                         : static_cast<uint32_t>(track->chunkOffsets.size());
+    lastChunk = std::min(lastChunk, static_cast<uint32_t>(track->chunkOffsets.size()));
+    for (auto chunk = firstChunk; chunk <= lastChunk && index < samples.size(); chunk++) {
+      auto offset = track->chunkOffsets[chunk - 1];
+      for (uint32_t k = 0; k < sampleToChunks[i].second && index < samples.size(); k++) {
+        samples[index].offset = offset;
+        samples[index].size = sampleSizes[index];
+        offset += sampleSizes[index];
+        index++;
+      }
+    }
+  }
+  // Drops the samples that are not located in any chunk.
+  samples.resize(index);
+  index = 0;
+  uint64_t decodeTime = 0;
+  for (auto& entry : track->timeToSamples) {
+    for (uint32_t k = 0; k < entry.first && index < samples.size(); k++) {
+      samples[index].pts = static_cast<int64_t>(decodeTime);
+      samples[index].duration = entry.second;
+      decodeTime += entry.second;
+      index++;
+    }
+  }
+  track->nextDecodeTime = decodeTime;
+  index = 0;
+  for (auto& entry : track->compositionOffsets) {
+    for (uint32_t k = 0; k < entry.first && index < samples.size(); k++) {
+      samples[index++].pts += entry.second;
+    }
+  }
+  for (auto& sample : samples) {
+    sample.isKeyframe = !track->hasSyncTable;
+  }
+  for (auto number : track->syncSamples) {
+    if (number > 0 && number <= samples.size()) {
+      samples[number - 1].isKeyframe = true;
+    }
+  }
+}
+
+static void ParseTRUN(DecodeStream* stream, uint64_t* dataOffset, uint64_t baseDataOffset,
+                      const MP4TrackDefaults& defaults, MP4VideoTrack* track) {
+  auto flags = stream->readUint32() & 0xFFFFFF;
+  auto sampleCount = stream->readUint32();
+  if (flags & 0x000001) {
+    *dataOffset = baseDataOffset + stream->readInt32();
+  }
+  auto firstSampleFlags = defaults.flags;
+  bool hasFirstSampleFlags = (flags & 0x000004) != 0;
+  if (hasFirstSampleFlags) {
+    firstSampleFlags = stream->readUint32();
+  }
+  uint32_t entrySize = 0;
+  for (uint32_t flag : {0x000100u, 0x000200u, 0x000400u, 0x000800u}) {
+    if (flags & flag) {
+      entrySize += 4;
+    }
+  }
+  // Every valid sample holds at least one byte of the file, which bounds the samples of all runs
+  // when the entries of this run do not carry any bytes.
+  auto maxSampleCount = entrySize > 0 ? stream->bytesAvailable() / entrySize
+                                      : track->fileLength / std::max(defaults.size, 1u);
+  if (stream->context->hasException() || sampleCount > maxSampleCount ||
+      track->samples.size() + sampleCount > track->fileLength) {
+    stream->context->throwException("MP4Demuxer: Invalid sample count.");
+    return;
+  }
+  track->samples.reserve(track->samples.size() + sampleCount);
+  for (uint32_t i = 0; i < sampleCount && !stream->context->hasException(); i++) {
+    MP4RawSample sample = {};
+    sample.duration = (flags & 0x000100) ? stream->readUint32() : defaults.duration;
+    sample.size = (flags & 0x000200) ? stream->readUint32() : defaults.size;
+    auto sampleFlags = (flags & 0x000400) ? stream->readUint32() : defaults.flags;
+    if (i == 0 && hasFirstSampleFlags) {
+      sampleFlags = firstSampleFlags;
+    }
+    int64_t compositionOffset = (flags & 0x000800) ? stream->readInt32() : 0;
+    sample.offset = *dataOffset;
+    sample.pts = static_cast<int64_t>(track->nextDecodeTime) + compositionOffset;
+    // The sample_is_non_sync_sample bit.
+    sample.isKeyframe = ((sampleFlags >> 16) & 0x01) == 0;
+    *dataOffset += sample.size;
+    track->nextDecodeTime += sample.duration;
+    track->samples.push_back(sample);
+  }
+}
+
+static void ParseTRAF(DecodeStream* stream, uint64_t moofOffset, MP4VideoTrack* track,
+                      const std::vector<MP4TrackDefaults>& trackDefaults) {
+  MP4TrackDefaults defaults = {};
+  for (auto& item : trackDefaults) {
+    if (item.trackID == track->trackID) {
+      defaults = item;
+    }
+  }
+  auto baseDataOffset = moofOffset;
+  auto dataOffset = moofOffset;
+  while (HasNextBox(stream)) {
+    uint32_t type = 0;
+    auto body = ReadBox(stream, &type);
+    if (type == BoxType("tfhd")) {
+      auto flags = body.readUint32() & 0xFFFFFF;
+      if (body.readUint32() != track->trackID) {
+        return;
+      }
+      if (flags & 0x000001) {
+        baseDataOffset = body.readUint64();
+      }
+      if (flags & 0x000002) {
+        body.skip(4);
+      }
+      if (flags & 0x000008) {
+        defaults.duration = body.readUint32();
+      }
+      if (flags & 0x000010) {
+        defaults.size = body.readUint32();
+      }
+      if (flags & 0x000020) {
+        defaults.flags = body.readUint32();
+      }
+      dataOffset = baseDataOffset;
+    } else if (type == BoxType("tfdt")) {
+      auto version = body.readUint8();
+      body.skip(3);
+      track->nextDecodeTime = version == 1 ? body.readUint64() : body.readUint32();
+    } else if (type == BoxType("trun")) {
+      ParseTRUN(&body, &dataOffset, baseDataOffset, defaults, track);
+    }
+  }
+}
+
+static std::unique_ptr<MP4VideoTrack> ParseVideoTrack(DecodeStream* stream) {
+  std::unique_ptr<MP4VideoTrack> videoTrack = nullptr;
+  std::vector<MP4TrackDefaults> trackDefaults = {};
+  while (HasNextBox(stream)) {
+    auto boxOffset = stream->position();
+    uint32_t type = 0;
+    auto body = ReadBox(stream, &type);
+    if (type == BoxType("moov")) {
+      while (HasNextBox(&body)) {
+        uint32_t childType = 0;
+        auto child = ReadBox(&body, &childType);
+        if (childType == BoxType("trak") && videoTrack == nullptr) {
+          auto track = std::make_unique<MP4VideoTrack>();
+          track->fileLength = stream->length();
+          ParseTrackBoxes(&child, track.get());
+          if (track->handlerType == BoxType("vide") && !track->headers.empty()) {
+            BuildTableSamples(track.get());
+            videoTrack = std::move(track);
+          }
+        } else if (childType == BoxType("mvex")) {
+          while (HasNextBox(&child)) {
+            uint32_t mvexType = 0;
+            auto trex = ReadBox(&child, &mvexType);
+            if (mvexType != BoxType("trex")) {
+              continue;
+            }
+            MP4TrackDefaults defaults = {};
+            trex.skip(4);
+            defaults.trackID = trex.readUint32();
+            // default_sample_description_index
+            trex.skip(4);
+            defaults.duration = trex.readUint32();
+            defaults.size = trex.readUint32();
+            defaults.flags = trex.readUint32();
+            trackDefaults.push_back(defaults);
+          }
+        }
+      }
+    } else if (type == BoxType("moof") && videoTrack != nullptr) {
+      while (HasNextBox(&body)) {
+        uint32_t childType = 0;
+        auto traf = ReadBox(&body, &childType);
+        if (childType == BoxType("traf")) {
+          ParseTRAF(&traf, boxOffset, videoTrack.get(), trackDefaults);
+        }
+      }
+    }
+  }
+  return videoTrack;
+}
+
+std::unique_ptr<MP4Demuxer> MP4Demuxer::Make(const std::string& filePath) {
+  auto fileData = ByteData::FromPath(filePath);
+  if (fileData == nullptr) {
+    LOGE("MP4Demuxer: Failed to read the file: %s", filePath.c_str());
+    return nullptr;
+  }
+  return Make(std::move(fileData));
+}
+
+std::unique_ptr<MP4Demuxer> MP4Demuxer::Make(std::unique_ptr<ByteData> fileData) {
+  if (fileData == nullptr || fileData->length() == 0 || fileData->length() > UINT32_MAX) {
+    return nullptr;
+  }
+  StreamContext context = {};
+  DecodeStream stream(&context, fileData->data(), static_cast<uint32_t>(fileData->length()));
+  stream.setByteOrder(tgfx::ByteOrder::BigEndian);
+  auto track = ParseVideoTrack(&stream);
+  if (context.hasException()) {
+    LOGE("%s", context.errorMessages.back().c_str());
+    return nullptr;
+  }
+  if (track == nullptr) {
+    LOGE("MP4Demuxer: There is no H.264 video track in the file.");
+    return nullptr;
+  }
+  auto demuxer = std::unique_ptr<MP4Demuxer>(new MP4Demuxer(std::move(fileData)));
+  if (!demuxer->init(track.get())) {
+    return nullptr;
+  }
+  return demuxer;
+}
+
+MP4Demuxer::MP4Demuxer(std::unique_ptr<ByteData> fileData) : fileData(std::move(fileData)) {
+}
+
+bool MP4Demuxer::init(MP4VideoTrack* track) {
+  auto& rawSamples = track->samples;
+  if (rawSamples.empty() || track->timescale == 0 || track->width <= 0 || track->height <= 0) {
+    LOGE("MP4Demuxer: The video track is empty or invalid.");
+    return false;
+  }
+  auto minPTS = rawSamples[0].pts;
+  auto endPTS = rawSamples[0].pts;
+  for (auto& rawSample : rawSamples) {
+    if (rawSample.size == 0 || rawSample.offset + rawSample.size > fileData->length()) {
+      LOGE("MP4Demuxer: The sample data is out of the file range.");
+      return false;
+    }
+    minPTS = std::min(minPTS, rawSample.pts);
+    endPTS = std::max(endPTS, rawSample.pts + rawSample.duration);
+  }
+  auto timescale = static_cast<int64_t>(track->timescale);
+  for (auto& rawSample : rawSamples) {
+    Sample sample = {};
+    sample.offset = static_cast<size_t>(rawSample.offset);
+    sample.size = rawSample.size;
+    sample.time = (rawSample.pts - minPTS) * 1000000 / timescale;
+    sample.isKeyframe = rawSample.isKeyframe;
+    samples.push_back(sample);
+  }
+  samples[0].isKeyframe = true;
+  std::vector<size_t> presentationOrder(samples.size());
+  for (size_t i = 0; i < samples.size(); i++) {
+    presentationOrder[i] = i;
+  }
+  std::stable_sort(presentationOrder.begin(), presentationOrder.end(),
+                   [this](size_t a, size_t b) { return samples[a].time < samples[b].time; });
+  int maxReorderSize = 0;
+  for (size_t rank = 0; rank < presentationOrder.size(); rank++) {
+    auto index = presentationOrder[rank];
+    sampleTimes.push_back(samples[index].time);
+    if (samples[index].isKeyframe) {
+      keyframes.push_back(index);
+    }
+    // A sample decoded before the ones presented ahead of it has to wait in the reorder buffer.
+    maxReorderSize = std::max(maxReorderSize, static_cast<int>(rank) - static_cast<int>(index));
+  }
+  lengthSize = track->lengthSize;
+  format.width = track->width;
+  format.height = track->height;
+  format.headers = track->headers;
+  format.mimeType = "video/avc";
+  format.colorSpace = tgfx::YUVColorSpace::BT601_LIMITED;
+  format.duration = std::max((endPTS - minPTS) * 1000000 / timescale, static_cast<int64_t>(1));
+  format.frameRate =
+      static_cast<float>(static_cast<double>(samples.size()) * 1000000.0 / format.duration);
+  format.maxReorderSize = maxReorderSize;
+  format.demuxer = this;
+  return true;
+}
+
+VideoSample MP4Demuxer::nextSample() {
+  if (sampleIndex >= samples.size()) {
+    return {};
+  }
+  auto& current = samples[sampleIndex];
+  auto data = fileData->data() + current.offset;
+  VideoSample sample = {};
+  if (lengthSize == 4 && Platform::Current()->naluType() == NALUType::AVCC) {
+    // The samples are already stored in the format the video decoders expect.
+    sample.data = data;
+    sample.length = current.size;
+  } else {
+    // Replaces the length prefix of each NALU in the sample with a 4-byte start code. The video
+    // decoders are done with the previous sample once they ask for the next one.
+    sampleBuffer.clear();
+    size_t position = 0;
+    while (position + lengthSize <= current.size) {
+      uint32_t naluLength = 0;
+      for (int i = 0; i < lengthSize; i++) {
+        naluLength = (naluLength << 8) | data[position++];
+      }
+      if (naluLength > current.size - position) {
+        break;
+      }
+      auto bufferSize = sampleBuffer.size();
+      sampleBuffer.resize(bufferSize + naluLength + 4);
+      WriteStartCode(sampleBuffer.data() + bufferSize, naluLength);
+      memcpy(sampleBuffer.data() + bufferSize + 4, data + position, naluLength);
+      position += naluLength;
+    }
+    sample.data = sampleBuffer.data();
+    sample.length = sampleBuffer.size();
+  }
+  sample.time = current.time;
+  maxPTS = std::max(maxPTS, current.time);
+  sampleIndex++;
+  return sample;
+}
+
+int64_t MP4Demuxer::getSampleTimeAt(int64_t targetTime) {
+  auto result = std::upper_bound(sampleTimes.begin(), sampleTimes.end(), targetTime);
+  if (result == sampleTimes.begin()) {
+    return sampleTimes.front();
+  }
+  auto previous = *(result - 1);
+  if (result == sampleTimes.end()) {
+    return previous;
+  }
+  return *result - targetTime < targetTime - previous ? *result : previous;
+}
+
+bool MP4Demuxer::needSeeking(int64_t currentTime, int64_t targetTime) {
+  if (targetTime < currentTime) {
+    return true;
+  }
+  if (targetTime <= maxPTS) {
+    return false;
+  }
+  // Seeking is faster if there is a keyframe between the current time and the target time.
+  for (auto index : keyframes) {
+    auto keyframeTime = samples[index].time;
+    if (keyframeTime > targetTime) {
+      break;
+    }
+    if (keyframeTime > currentTime) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MP4Demuxer::seekTo(int64_t targetTime) {
+  auto keyframe = keyframes.front();
+  for (auto index : keyframes) {
+    if (samples[index].time > targetTime) {
+      break;
+    }
+    keyframe = index;
+  }
+  sampleIndex = keyframe;
+  maxPTS = samples[keyframe].time;
+}
+
+void MP4Demuxer::reset() {
+  maxPTS = INT64_MIN;
+  sampleIndex = 0;
+}
+}  // namespace pag
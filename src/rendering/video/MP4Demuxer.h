@@ -0,0 +1,93 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <climits>
+#include "pag/types.h"
+#include "rendering/video/VideoDemuxer.h"
+
+namespace pag {
+struct MP4VideoTrack;
+
+/**
+ * MP4Demuxer extracts the H.264 samples of the first video track in an MP4 file. Both the sample
+ * tables in the moov box and the movie fragments (moof) are supported. Edit lists are ignored, the
+ * presentation times are shifted so that the first frame starts at zero instead.
+ */
+class MP4Demuxer : public VideoDemuxer {
+ public:
+  /**
+   * Creates a MP4Demuxer from the specified file path. Returns nullptr if the file does not exist
+   * or does not contain any H.264 video track.
+   */
+  static std::unique_ptr<MP4Demuxer> Make(const std::string& filePath);
+
+  /**
+   * Creates a MP4Demuxer from the specified file data. Returns nullptr if the data does not
+   * contain any H.264 video track.
+   */
+  static std::unique_ptr<MP4Demuxer> Make(std::unique_ptr<ByteData> fileData);
+
+  /**
+   * Returns the number of samples in the video track.
+   */
+  int sampleCount() const {
+    return static_cast<int>(samples.size());
+  }
+
+  VideoFormat getFormat() override {
+    return format;
+  }
+
+  VideoSample nextSample() override;
+
+  int64_t getSampleTimeAt(int64_t targetTime) override;
+
+  bool needSeeking(int64_t currentTime, int64_t targetTime) override;
+
+  void seekTo(int64_t targetTime) override;
+
+  void reset() override;
+
+ private:
+  struct Sample {
+    size_t offset = 0;
+    size_t size = 0;
+    int64_t time = 0;
+    bool isKeyframe = false;
+  };
+
+  std::unique_ptr<ByteData> fileData = nullptr;
+  VideoFormat format = {};
+  int lengthSize = 4;
+  // The samples in decoding order.
+  std::vector<Sample> samples = {};
+  // The presentation times of all samples in ascending order.
+  std::vector<int64_t> sampleTimes = {};
+  // The indexes of the sync samples, sorted by their presentation times.
+  std::vector<size_t> keyframes = {};
+  size_t sampleIndex = 0;
+  int64_t maxPTS = INT64_MIN;
+  std::vector<uint8_t> sampleBuffer = {};
+
+  explicit MP4Demuxer(std::unique_ptr<ByteData> fileData);
+
+  bool init(MP4VideoTrack* track);
+};
+}  // namespace pag
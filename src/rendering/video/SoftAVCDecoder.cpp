@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SoftAVCDecoder.h"
+#include <algorithm>
 #include <cstdlib>
 #include "tgfx/utils/Buffer.h"
 
@@ -88,6 +89,9 @@ bool SoftAVCDecoder::onConfigure(const std::vector<HeaderData>& headers, std::st
   return openDecoder();
 }
 
+SoftAVCDecoder::SoftAVCDecoder(int numCores) : numCores(std::max(numCores, 1)) {
+}
+
 SoftAVCDecoder::~SoftAVCDecoder() {
   destroyDecoder();
   delete outputFrame;
@@ -279,7 +283,7 @@ bool SoftAVCDecoder::setNumCores() {
   ih264d_ctl_set_num_cores_op_t s_set_cores_op;
   s_set_cores_ip.e_cmd = IVD_CMD_VIDEO_CTL;
   s_set_cores_ip.e_sub_cmd = (IVD_CONTROL_API_COMMAND_TYPE_T)IH264D_CMD_CTL_SET_NUM_CORES;
-  s_set_cores_ip.u4_num_cores = 1;
+  s_set_cores_ip.u4_num_cores = static_cast<UWORD32>(numCores);
   s_set_cores_ip.u4_size = sizeof(ih264d_ctl_set_num_cores_ip_t);
   s_set_cores_op.u4_size = sizeof(ih264d_ctl_set_num_cores_op_t);
   auto status = ih264d_api_function(codecContext, &s_set_cores_ip, &s_set_cores_op);
@@ -43,6 +43,12 @@ namespace pag {
  */
 class SoftAVCDecoder : public SoftwareDecoder {
  public:
+  /**
+   * Creates a SoftAVCDecoder that decodes with the specified number of CPU cores. libavc may use
+   * fewer threads than requested.
+   */
+  explicit SoftAVCDecoder(int numCores = 1);
+
   ~SoftAVCDecoder() override;
 
   bool onConfigure(const std::vector<HeaderData>& headers, std::string mime, int width,
@@ -65,6 +71,7 @@ class SoftAVCDecoder : public SoftwareDecoder {
   ivd_video_decode_ip_t decodeInput = {};
   ivd_video_decode_op_t decodeOutput = {};
   bool flushed = true;
+  int numCores = 1;
 
   bool initDecoder();
   bool openDecoder();
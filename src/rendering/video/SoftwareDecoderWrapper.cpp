@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SoftwareDecoderWrapper.h"
+#include <cstring>
 #include "platform/Platform.h"
 #include "tgfx/core/YUVData.h"
 
@@ -72,6 +73,69 @@ class SoftwareI420Data : public tgfx::YUVData {
   }
 };
 
+class CopiedI420Data : public tgfx::YUVData {
+ public:
+  static std::shared_ptr<YUVData> Make(int width, int height, uint8_t* buffer[3],
+                                       const int lineSize[3]) {
+    auto data = new CopiedI420Data(width, height);
+    if (data->buffer.isEmpty()) {
+      delete data;
+      return nullptr;
+    }
+    auto pixels = data->buffer.bytes();
+    for (size_t i = 0; i < tgfx::YUVData::I420_PLANE_COUNT; i++) {
+      auto rowBytes = data->rowBytes[i];
+      auto rowCount = i == 0 ? height : (height + 1) / 2;
+      auto src = buffer[i];
+      auto dst = pixels + data->offsets[i];
+      for (int row = 0; row < rowCount; row++) {
+        memcpy(dst, src, rowBytes);
+        src += lineSize[i];
+        dst += rowBytes;
+      }
+    }
+    return std::shared_ptr<YUVData>(data);
+  }
+
+ private:
+  int width() const override {
+    return _width;
+  }
+
+  int height() const override {
+    return _height;
+  }
+
+  size_t planeCount() const override {
+    return tgfx::YUVData::I420_PLANE_COUNT;
+  }
+
+  const void* getBaseAddressAt(size_t planeIndex) const override {
+    return buffer.bytes() + offsets[planeIndex];
+  }
+
+  size_t getRowBytesAt(size_t planeIndex) const override {
+    return rowBytes[planeIndex];
+  }
+
+ private:
+  int _width = 0;
+  int _height = 0;
+  tgfx::Buffer buffer = {};
+  size_t offsets[3] = {};
+  size_t rowBytes[3] = {};
+
+  CopiedI420Data(int width, int height) : _width(width), _height(height) {
+    auto chromaWidth = static_cast<size_t>((width + 1) / 2);
+    auto chromaHeight = static_cast<size_t>((height + 1) / 2);
+    rowBytes[0] = static_cast<size_t>(width);
+    rowBytes[1] = rowBytes[2] = chromaWidth;
+    offsets[1] = rowBytes[0] * static_cast<size_t>(height);
+    offsets[2] = offsets[1] + chromaWidth * chromaHeight;
+    buffer.alloc(offsets[2] + chromaWidth * chromaHeight);
+  }
+};
+
 std::unique_ptr<VideoDecoder> SoftwareDecoderWrapper::Wrap(
     std::shared_ptr<SoftwareDecoder> softwareDecoder, const VideoFormat& format) {
   if (softwareDecoder == nullptr) {
@@ -201,6 +265,24 @@ std::shared_ptr<tgfx::ImageBuffer> SoftwareDecoderWrapper::onRenderFrame() {
   return tgfx::ImageBuffer::MakeI420(std::move(yuvData), videoFormat.colorSpace);
 }
 
+std::shared_ptr<tgfx::ImageBuffer> SoftwareDecoderWrapper::onRenderFrameCopy() {
+  auto frame = softwareDecoder->onRenderFrame();
+  if (frame == nullptr) {
+    return nullptr;
+  }
+  auto yuvData =
+      CopiedI420Data::Make(videoFormat.width, videoFormat.height, frame->data, frame->lineSize);
+  if (yuvData == nullptr) {
+    return nullptr;
+  }
+  return tgfx::ImageBuffer::MakeI420(std::move(yuvData), videoFormat.colorSpace);
+}
+
+bool SoftwareDecoderWrapper::isReusable() const {
+  // The frames from onRenderFrame() hold a reference to the software decoder.
+  return softwareDecoder.use_count() == 1;
+}
+
 int64_t SoftwareDecoderWrapper::presentationTime() {
   return currentDecodedTime;
 }
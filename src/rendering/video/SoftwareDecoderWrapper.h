@@ -43,6 +43,10 @@ class SoftwareDecoderWrapper : public VideoDecoder {
 
   std::shared_ptr<tgfx::ImageBuffer> onRenderFrame() override;
 
+  std::shared_ptr<tgfx::ImageBuffer> onRenderFrameCopy() override;
+
+  bool isReusable() const override;
+
   int64_t presentationTime() override;
 
  private:
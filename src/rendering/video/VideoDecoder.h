@@ -61,6 +61,24 @@ class VideoDecoder {
    */
   virtual std::shared_ptr<tgfx::ImageBuffer> onRenderFrame() = 0;
 
+  /**
+   * Returns a copy of the decoded video frame that does not share memory with the decoder, so it
+   * remains valid while the following frames are decoded. Returns nullptr if the decoder does not
+   * support copying its frames, which is the default implementation.
+   */
+  virtual std::shared_ptr<tgfx::ImageBuffer> onRenderFrameCopy() {
+    return nullptr;
+  }
+
+  /**
+   * Returns true if the decoder can be handed over to another video reader, which requires that no
+   * decoded frame still refers to the memory of the decoder. The default implementation returns
+   * false.
+   */
+  virtual bool isReusable() const {
+    return false;
+  }
+
   /**
    * Returns current presentation time.
    */
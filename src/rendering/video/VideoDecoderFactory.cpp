@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "VideoDecoderFactory.h"
+#include <algorithm>
 #include <atomic>
 #include "SoftAVCDecoder.h"
 #include "SoftwareDecoderWrapper.h"
@@ -32,6 +33,7 @@ static std::mutex factoryLocker = {};
 static SoftwareDecoderFactory* softwareDecoderFactory = {nullptr};
 static std::atomic_int maxHardwareDecoderCount = {65535};
 static std::atomic_int globalHardwareDecoderCount = {0};
+static std::atomic_int softwareDecoderCoreCount = {1};
 
 void PAGVideoDecoder::RegisterSoftwareDecoderFactory(SoftwareDecoderFactory* decoderFactory) {
   std::lock_guard<std::mutex> autoLock(factoryLocker);
@@ -42,6 +44,10 @@ void PAGVideoDecoder::SetMaxHardwareDecoderCount(int count) {
   maxHardwareDecoderCount = count;
 }
 
+void PAGVideoDecoder::SetSoftwareDecoderCoreCount(int count) {
+  softwareDecoderCoreCount = std::max(count, 1);
+}
+
 static SoftwareDecoderFactory* GetSoftwareDecoderFactory() {
   if (softwareDecoderFactory) {
     return softwareDecoderFactory;
@@ -82,7 +88,8 @@ class SoftwareAVCDecoderFactory : public VideoDecoderFactory {
   std::unique_ptr<VideoDecoder> onCreateDecoder(const VideoFormat& format) const override {
     std::unique_ptr<VideoDecoder> videoDecoder = nullptr;
 #ifdef PAG_USE_LIBAVC
-    videoDecoder = SoftwareDecoderWrapper::Wrap(std::make_shared<SoftAVCDecoder>(), format);
+    auto softwareDecoder = std::make_shared<SoftAVCDecoder>(softwareDecoderCoreCount);
+    videoDecoder = SoftwareDecoderWrapper::Wrap(std::move(softwareDecoder), format);
     if (videoDecoder != nullptr) {
       LOGI("All other video decoders are not available, fallback to SoftAVCDecoder!");
     }
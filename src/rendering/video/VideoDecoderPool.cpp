@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "VideoDecoderPool.h"
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include "pag/pag.h"
+#include "tgfx/utils/Clock.h"
+
+namespace pag {
+struct PooledDecoder {
+  std::string key;
+  std::unique_ptr<VideoDecoder> decoder;
+  int64_t recycledTime;
+};
+
+static std::mutex poolLocker = {};
+// The least recently recycled decoders are in the front.
+static std::list<PooledDecoder> pooledDecoders = {};
+static std::atomic_int maxPooledDecoderCount = {0};
+static std::atomic_int64_t pooledDecoderIdleTime = {10000000};
+
+void PAGVideoDecoder::SetMaxPooledDecoderCount(int count) {
+  maxPooledDecoderCount = std::max(count, 0);
+  VideoDecoderPool::Purge();
+}
+
+void PAGVideoDecoder::SetPooledDecoderIdleTime(int64_t time) {
+  pooledDecoderIdleTime = std::max(time, static_cast<int64_t>(0));
+  VideoDecoderPool::Purge();
+}
+
+static std::string MakeDecoderKey(const VideoDecoderFactory* factory, const VideoFormat& format) {
+  auto key = std::to_string(reinterpret_cast<uintptr_t>(factory)) + "|" + format.mimeType + "|" +
+             std::to_string(format.width) + "x" + std::to_string(format.height) + "|" +
+             std::to_string(static_cast<int>(format.colorSpace));
+  for (auto& header : format.headers) {
+    key += "|";
+    key.append(reinterpret_cast<const char*>(header->bytes()), header->size());
+  }
+  return key;
+}
+
+// The expired decoders are handed out to be destroyed after the locker is released.
+static void PurgeLocked(std::vector<std::unique_ptr<VideoDecoder>>* expiredDecoders) {
+  auto expiredTime = tgfx::Clock::Now() - pooledDecoderIdleTime;
+  auto maxCount = static_cast<size_t>(maxPooledDecoderCount);
+  while (!pooledDecoders.empty() && (pooledDecoders.size() > maxCount ||
+                                     pooledDecoders.front().recycledTime < expiredTime)) {
+    expiredDecoders->push_back(std::move(pooledDecoders.front().decoder));
+    pooledDecoders.pop_front();
+  }
+}
+
+bool VideoDecoderPool::Accepts(const VideoDecoderFactory* factory) {
+  // The hardware decoders are limited resources, keeping idle ones would block other players.
+  return factory != nullptr && !factory->isHardwareBacked() && maxPooledDecoderCount > 0;
+}
+
+std::unique_ptr<VideoDecoder> VideoDecoderPool::Obtain(const VideoDecoderFactory* factory,
+                                                       const VideoFormat& format) {
+  if (!Accepts(factory)) {
+    return nullptr;
+  }
+  auto key = MakeDecoderKey(factory, format);
+  std::vector<std::unique_ptr<VideoDecoder>> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(poolLocker);
+  PurgeLocked(&expiredDecoders);
+  // Takes the most recently recycled one, which is the least likely to expire.
+  auto result = std::find_if(pooledDecoders.rbegin(), pooledDecoders.rend(),
+                             [&key](const PooledDecoder& item) { return item.key == key; });
+  if (result == pooledDecoders.rend()) {
+    return nullptr;
+  }
+  auto decoder = std::move(result->decoder);
+  pooledDecoders.erase(std::next(result).base());
+  return decoder;
+}
+
+void VideoDecoderPool::Recycle(const VideoDecoderFactory* factory, const VideoFormat& format,
+                               std::unique_ptr<VideoDecoder> decoder) {
+  if (decoder == nullptr || !Accepts(factory) || !decoder->isReusable()) {
+    return;
+  }
+  // Clears the pending frames, so the next reader starts from a keyframe like a new decoder.
+  decoder->onFlush();
+  auto key = MakeDecoderKey(factory, format);
+  std::vector<std::unique_ptr<VideoDecoder>> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(poolLocker);
+  pooledDecoders.push_back({std::move(key), std::move(decoder), tgfx::Clock::Now()});
+  PurgeLocked(&expiredDecoders);
+}
+
+void VideoDecoderPool::Purge() {
+  std::vector<std::unique_ptr<VideoDecoder>> expiredDecoders = {};
+  std::lock_guard<std::mutex> autoLock(poolLocker);
+  PurgeLocked(&expiredDecoders);
+}
+}  // namespace pag
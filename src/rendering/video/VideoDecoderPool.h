@@ -0,0 +1,56 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "VideoDecoderFactory.h"
+
+namespace pag {
+/**
+ * VideoDecoderPool keeps the software video decoders released by the video readers of the whole
+ * process, so that the following readers decoding videos of the same format can take them out
+ * instead of creating and configuring new ones. The pool is disabled by default, use
+ * PAGVideoDecoder::SetMaxPooledDecoderCount() to enable it.
+ */
+class VideoDecoderPool {
+ public:
+  /**
+   * Returns true if the video decoders created by the specified factory can be kept in the pool.
+   */
+  static bool Accepts(const VideoDecoderFactory* factory);
+
+  /**
+   * Takes out an idle video decoder created by the specified factory for the same format. Returns
+   * nullptr if there is none.
+   */
+  static std::unique_ptr<VideoDecoder> Obtain(const VideoDecoderFactory* factory,
+                                              const VideoFormat& format);
+
+  /**
+   * Puts the video decoder back into the pool for reuse. The decoder is destroyed instead if it is
+   * not reusable or the pool is full.
+   */
+  static void Recycle(const VideoDecoderFactory* factory, const VideoFormat& format,
+                      std::unique_ptr<VideoDecoder> decoder);
+
+  /**
+   * Destroys the idle video decoders that exceed the count or idle time limits.
+   */
+  static void Purge();
+};
+}  // namespace pag
@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "base/utils/TimeUtil.h"
+#include "ffavc.h"
+#include "nlohmann/json.hpp"
+#include "pag/pag.h"
+#include "rendering/caches/RenderCache.h"
+#include "tgfx/utils/Clock.h"
+#include "utils/OffscreenSurface.h"
+#include "utils/ProjectPath.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * PAGBenchmark renders a corpus of pag files through PAGPlayer and PAGDecoder and prints the
+ * timings as JSON. Usage:
+ *
+ *   PAGBenchmark [-o output.json] [file.pag ...]
+ *
+ * If no file is specified, the default corpus in the resources/ directory is used. All times are in
+ * microseconds and all memory sizes are in bytes.
+ */
+namespace pag {
+using nlohmann::json;
+
+static constexpr float MAX_FRAME_SIZE = 720.0f;
+
+static const std::vector<std::string> DefaultCorpus = {
+    "resources/apitest/test.pag",
+    "resources/apitest/complex_test.pag",
+    "resources/apitest/ZC2.pag",
+    "resources/apitest/ZC_mg_seky2_landscape.pag",
+    "resources/apitest/AlphaTrackMatte.pag",
+    "resources/apitest/ShaderToyTest.pag",
+    "resources/apitest/TEXT04.pag",
+    "resources/apitest/bitmap_sequence_test.pag",
+    "resources/apitest/data_bmp.pag",
+    "resources/apitest/polygon_round_corner.pag",
+};
+
+static void SetUpEnvironment() {
+  std::vector<std::string> fontPaths = {
+      ProjectPath::Absolute("resources/font/NotoSansSC-Regular.otf"),
+      ProjectPath::Absolute("resources/font/NotoColorEmoji.ttf")};
+  std::vector<int> ttcIndices = {0, 0};
+  PAGFont::SetFallbackFontPaths(fontPaths, ttcIndices);
+  auto factory = ffavc::DecoderFactory::GetHandle();
+  PAGVideoDecoder::RegisterSoftwareDecoderFactory(
+      reinterpret_cast<pag::SoftwareDecoderFactory*>(factory));
+}
+
+static size_t PeakResidentMemory() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters = {};
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return 0;
+  }
+  return counters.PeakWorkingSetSize;
+#else
+  struct rusage usage = {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss);
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/**
+ * Returns the value at the given percentile using the nearest-rank method.
+ */
+static int64_t Percentile(const std::vector<int64_t>& sortedTimes, double percent) {
+  if (sortedTimes.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(ceil(percent / 100.0 * static_cast<double>(sortedTimes.size())));
+  rank = std::clamp(rank, static_cast<size_t>(1), sortedTimes.size());
+  return sortedTimes[rank - 1];
+}
+
+static json FrameTimeSummary(std::vector<int64_t> frameTimes) {
+  std::sort(frameTimes.begin(), frameTimes.end());
+  int64_t totalTime = 0;
+  for (auto time : frameTimes) {
+    totalTime += time;
+  }
+  json summary = {};
+  summary["frameCount"] = frameTimes.size();
+  summary["totalTime"] = totalTime;
+  summary["average"] = frameTimes.empty() ? 0 : totalTime / static_cast<int64_t>(frameTimes.size());
+  summary["p50"] = Percentile(frameTimes, 50);
+  summary["p99"] = Percentile(frameTimes, 99);
+  summary["max"] = frameTimes.empty() ? 0 : frameTimes.back();
+  return summary;
+}
+
+static float GetScaleFactor(int width, int height) {
+  auto maxSize = static_cast<float>(std::max(width, height));
+  return maxSize > MAX_FRAME_SIZE ? MAX_FRAME_SIZE / maxSize : 1.0f;
+}
+
+static json RunPlayer(const std::string& pagPath) {
+  auto pagFile = PAGFile::Load(pagPath);
+  if (pagFile == nullptr) {
+    return nullptr;
+  }
+  auto scale = GetScaleFactor(pagFile->width(), pagFile->height());
+  auto width = static_cast<int>(roundf(static_cast<float>(pagFile->width()) * scale));
+  auto height = static_cast<int>(roundf(static_cast<float>(pagFile->height()) * scale));
+  auto pagSurface = OffscreenSurface::Make(width, height);
+  if (pagSurface == nullptr) {
+    return nullptr;
+  }
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(height));
+  int64_t renderingTime = 0;
+  int64_t imageDecodingTime = 0;
+  int64_t textureUploadingTime = 0;
+  int64_t programCompilingTime = 0;
+  int64_t presentingTime = 0;
+  int64_t readPixelsTime = 0;
+  std::vector<int64_t> frameTimes = {};
+  auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+  for (Frame frame = 0; frame < totalFrames; frame++) {
+    auto startTime = tgfx::Clock::Now();
+    pagPlayer->flush();
+    auto flushTime = tgfx::Clock::Now();
+    pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(),
+                           rowBytes);
+    auto endTime = tgfx::Clock::Now();
+    frameTimes.push_back(endTime - startTime);
+    readPixelsTime += endTime - flushTime;
+    auto cache = pagPlayer->renderCache;
+    // The rendering stage excludes every stage reported separately below, so the stages sum up to
+    // the total time of a flush.
+    renderingTime += cache->totalTime - cache->presentingTime - cache->imageDecodingTime -
+                     cache->textureUploadingTime - cache->programCompilingTime;
+    imageDecodingTime += cache->imageDecodingTime;
+    textureUploadingTime += cache->textureUploadingTime;
+    programCompilingTime += cache->programCompilingTime;
+    presentingTime += cache->presentingTime;
+    pagPlayer->nextFrame();
+  }
+  auto result = FrameTimeSummary(std::move(frameTimes));
+  result["width"] = width;
+  result["height"] = height;
+  result["stages"] = {{"rendering", renderingTime},
+                      {"imageDecoding", imageDecodingTime},
+                      {"textureUploading", textureUploadingTime},
+                      {"programCompiling", programCompilingTime},
+                      {"presenting", presentingTime},
+                      {"readPixels", readPixelsTime}};
+  result["graphicsMemory"] = pagPlayer->graphicsMemory();
+  return result;
+}
+
+static json ReadDecoderFrames(std::shared_ptr<PAGDecoder> decoder) {
+  auto rowBytes = static_cast<size_t>(decoder->width()) * 4;
+  std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(decoder->height()));
+  std::vector<int64_t> frameTimes = {};
+  auto numFrames = decoder->numFrames();
+  for (int index = 0; index < numFrames; index++) {
+    auto startTime = tgfx::Clock::Now();
+    decoder->readFrame(index, pixels.data(), rowBytes);
+    frameTimes.push_back(tgfx::Clock::Now() - startTime);
+  }
+  return FrameTimeSummary(std::move(frameTimes));
+}
+
+static json RunDecoder(const std::string& pagPath) {
+  auto pagFile = PAGFile::Load(pagPath);
+  if (pagFile == nullptr) {
+    return nullptr;
+  }
+  auto scale = GetScaleFactor(pagFile->width(), pagFile->height());
+  // Make sure the first pass renders every frame instead of reading a cache left by previous runs.
+  PAGDiskCache::RemoveAll();
+  auto decoder = PAGDecoder::MakeFrom(pagFile, 30.0f, scale);
+  if (decoder == nullptr) {
+    return nullptr;
+  }
+  json result = {};
+  result["width"] = decoder->width();
+  result["height"] = decoder->height();
+  result["rendering"] = ReadDecoderFrames(decoder);
+  // The second pass reads every frame back from the disk cache written by the first pass.
+  decoder = nullptr;
+  decoder = PAGDecoder::MakeFrom(pagFile, 30.0f, scale);
+  if (decoder == nullptr) {
+    return nullptr;
+  }
+  result["diskCache"] = ReadDecoderFrames(decoder);
+  return result;
+}
+}  // namespace pag
+
+int main(int argc, char** argv) {
+  std::string outputPath = {};
+  std::vector<std::string> files = {};
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else {
+      files.push_back(arg);
+    }
+  }
+  if (files.empty()) {
+    for (auto& file : pag::DefaultCorpus) {
+      files.push_back(pag::ProjectPath::Absolute(file));
+    }
+  }
+  pag::SetUpEnvironment();
+  pag::json report = {};
+  report["version"] = pag::PAG::SDKVersion();
+  report["files"] = pag::json::array();
+  bool success = true;
+  for (auto& file : files) {
+    pag::json item = {};
+    item["path"] = file;
+    item["player"] = pag::RunPlayer(file);
+    item["decoder"] = pag::RunDecoder(file);
+    if (item["player"].is_null() || item["decoder"].is_null()) {
+      std::cerr << "PAGBenchmark: failed to render " << file << std::endl;
+      success = false;
+    }
+    item["peakRSS"] = pag::PeakResidentMemory();
+    report["files"].push_back(item);
+  }
+  report["peakRSS"] = pag::PeakResidentMemory();
+  auto text = report.dump(2);
+  if (outputPath.empty()) {
+    std::cout << text << std::endl;
+  } else {
+    std::ofstream output(outputPath);
+    output << text << std::endl;
+  }
+  return success ? 0 : 1;
+}
@@ -16,12 +16,16 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <filesystem>
+#include <thread>
+#include "base/utils/TimeUtil.h"
 #include "pag/pag.h"
 #include "platform/Platform.h"
 #include "rendering/caches/DiskCache.h"
 #include "rendering/utils/BitmapBuffer.h"
 #include "rendering/utils/Directory.h"
+#include "rendering/utils/VaryingTimeRanges.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -77,6 +81,106 @@ namespace pag {
 //  std::filesystem::remove_all(cacheDir);
 //}
 
+/**
+ * 用例描述: 测试多个线程并发读取同一个 SequenceFile。
+ */
+PAG_TEST(PAGDiskCacheTest, SequenceFile_ParallelRead) {
+  auto cacheDir = Platform::Current()->getCacheDir();
+  std::filesystem::remove_all(cacheDir);
+  std::filesystem::create_directories(cacheDir);
+  std::filesystem::copy(ProjectPath::Absolute("resources/disk/libpag"), cacheDir,
+                        std::filesystem::copy_options::recursive);
+  auto pagFile = LoadPAGFile("resources/apitest/ZC2.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto info = tgfx::ImageInfo::Make(360, 640, tgfx::ColorType::RGBA_8888);
+  auto sequenceFile =
+      DiskCache::OpenSequence("resources/apitest/ZC2.pag.360x640", info, 30, pagFile->frameRate());
+  ASSERT_TRUE(sequenceFile != nullptr);
+  ASSERT_TRUE(sequenceFile->isComplete());
+  std::vector<tgfx::Bitmap> bitmaps = {};
+  std::vector<std::thread> threads = {};
+  std::atomic_int failedCount = 0;
+  for (int i = 0; i < 4; i++) {
+    bitmaps.emplace_back(info.width(), info.height(), false, false);
+  }
+  for (auto& bitmap : bitmaps) {
+    threads.emplace_back([&bitmap, &failedCount, sequenceFile]() {
+      tgfx::Pixmap pixmap(bitmap);
+      auto buffer = BitmapBuffer::Wrap(pixmap.info(), pixmap.writablePixels());
+      for (int index = 0; index <= 20; index++) {
+        if (!sequenceFile->readFrame(index, buffer)) {
+          failedCount++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failedCount, 0);
+  for (auto& bitmap : bitmaps) {
+    tgfx::Pixmap pixmap(bitmap);
+    EXPECT_TRUE(Baseline::Compare(pixmap, "PAGDiskCacheTest/SequenceFile_20"));
+  }
+  sequenceFile = nullptr;
+  pag::PAGDiskCache::RemoveAll();
+}
+
+/**
+ * 用例描述: 测试 SequenceFile 按关键帧间隔存储差分帧。
+ */
+PAG_TEST(PAGDiskCacheTest, SequenceFile_DeltaFrames) {
+  auto cacheDir = Platform::Current()->getCacheDir();
+  std::filesystem::remove_all(cacheDir);
+  std::filesystem::create_directories(cacheDir);
+  auto keyframeInterval = PAGDiskCache::KeyframeInterval();
+  ScopedSetting restoreInterval(
+      [keyframeInterval]() { PAGDiskCache::SetKeyframeInterval(keyframeInterval); });
+  PAGDiskCache::SetKeyframeInterval(4);
+  EXPECT_EQ(PAGDiskCache::KeyframeInterval(), 4);
+  auto pagFile = LoadPAGFile("resources/apitest/ZC2.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto info = tgfx::ImageInfo::Make(360, 640, tgfx::ColorType::RGBA_8888);
+  auto sequenceFile =
+      DiskCache::OpenSequence("resources/apitest/ZC2.pag.delta", info, 30, pagFile->frameRate());
+  ASSERT_TRUE(sequenceFile != nullptr);
+  auto pagSurface = OffscreenSurface::Make(info.width(), info.height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setSurface(pagSurface);
+  tgfx::Bitmap bitmap(info.width(), info.height(), false, false);
+  tgfx::Pixmap pixmap(bitmap);
+  auto buffer = BitmapBuffer::Wrap(pixmap.info(), pixmap.writablePixels());
+  std::vector<uint8_t> expectedPixels = {};
+  for (int i = 0; i < 30; i++) {
+    pagPlayer->flush();
+    auto success = pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                          pixmap.writablePixels(), pixmap.rowBytes());
+    ASSERT_TRUE(success);
+    EXPECT_TRUE(sequenceFile->writeFrame(i, buffer));
+    if (i == 13) {
+      auto pixels = static_cast<const uint8_t*>(pixmap.pixels());
+      expectedPixels.assign(pixels, pixels + pixmap.byteSize());
+    }
+    pagPlayer->nextFrame();
+  }
+  EXPECT_TRUE(sequenceFile->isComplete());
+  EXPECT_EQ(sequenceFile->frames[12].referenceSize, 0u);
+  EXPECT_GT(sequenceFile->frames[13].referenceSize, 0u);
+  sequenceFile = nullptr;
+  PAGDiskCache::SetKeyframeInterval(0);
+
+  sequenceFile =
+      DiskCache::OpenSequence("resources/apitest/ZC2.pag.delta", info, 30, pagFile->frameRate());
+  ASSERT_TRUE(sequenceFile != nullptr);
+  EXPECT_TRUE(sequenceFile->isComplete());
+  EXPECT_EQ(sequenceFile->keyframeInterval, 4);
+  EXPECT_TRUE(sequenceFile->readFrame(13, buffer));
+  EXPECT_EQ(memcmp(pixmap.pixels(), expectedPixels.data(), expectedPixels.size()), 0);
+  sequenceFile = nullptr;
+  pag::PAGDiskCache::RemoveAll();
+}
+
 /**
  * 用例描述: 测试 SequenceFile 的磁盘缓存功能。
  */
@@ -415,6 +519,104 @@ PAG_TEST(PAGDiskCacheTest, PAGDecoder_StaticTimeRanges) {
   pag::PAGDiskCache::RemoveAll();
 }
 
+static std::vector<TimeRange> SweepStaticTimeRanges(std::shared_ptr<PAGComposition> composition,
+                                                    int numFrames) {
+  std::vector<TimeRange> timeRanges = {};
+  auto startTime = composition->startTimeInternal();
+  auto duration = composition->durationInternal();
+  composition->gotoTime(startTime);
+  TimeRange timeRange = {0, 0};
+  for (int i = 1; i < numFrames; i++) {
+    auto progress = FrameToProgress(static_cast<Frame>(i), numFrames);
+    if (!composition->gotoTime(startTime + ProgressToTime(progress, duration))) {
+      timeRange.end++;
+      continue;
+    }
+    if (timeRange.duration() > 1) {
+      timeRanges.push_back(timeRange);
+    }
+    timeRange = {i, i};
+  }
+  if (timeRange.duration() > 1) {
+    timeRanges.push_back(timeRange);
+  }
+  return timeRanges;
+}
+
+/**
+ * 用例描述: 测试由图层缓存静态区间推导出的 PAGDecoder 静态区间与逐帧 gotoTime 的结果一致。
+ */
+PAG_TEST(PAGDiskCacheTest, PAGDecoder_VaryingTimeRanges) {
+  std::vector<std::string> paths = {
+      "resources/apitest/ImageDecodeTest.pag", "resources/apitest/polygon.pag",
+      "resources/apitest/AlphaTrackMatte.pag", "resources/apitest/complex_test.pag",
+      "resources/apitest/test_LayerWithComplexTimeRemap.pag"};
+  for (auto& path : paths) {
+    auto pagFile = LoadPAGFile(path);
+    ASSERT_TRUE(pagFile != nullptr);
+    for (auto maxFrameRate : {10.0f, 60.0f}) {
+      VaryingTimeRanges varyingRanges = {};
+      EXPECT_TRUE(pagFile->collectVaryingTimeRanges(0, &varyingRanges));
+      auto numFrames = PAGDecoder::GetFrameCountAndRate(pagFile, maxFrameRate).first;
+      auto timeRanges = PAGDecoder::GetStaticTimeRange(pagFile, numFrames);
+      auto expectedRanges = SweepStaticTimeRanges(pagFile, numFrames);
+      ASSERT_EQ(timeRanges.size(), expectedRanges.size());
+      for (size_t i = 0; i < timeRanges.size(); i++) {
+        EXPECT_EQ(timeRanges[i].start, expectedRanges[i].start);
+        EXPECT_EQ(timeRanges[i].end, expectedRanges[i].end);
+      }
+    }
+  }
+  auto pagFile = LoadPAGFile("resources/apitest/ImageDecodeTest.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  pagFile->setDuration(pagFile->duration() * 2);
+  VaryingTimeRanges varyingRanges = {};
+  EXPECT_FALSE(pagFile->collectVaryingTimeRanges(0, &varyingRanges));
+}
+
+PAG_TEST(PAGDiskCacheTest, PAGDecoder_ReadFrames) {
+  pag::PAGDiskCache::RemoveAll();
+  auto pagFile = LoadPAGFile("resources/apitest/data_bmp.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto decoder = PAGDecoder::MakeFrom(pagFile, 30, 0.5f);
+  ASSERT_TRUE(decoder != nullptr);
+  pagFile = nullptr;
+  tgfx::Bitmap bitmap(decoder->width(), decoder->height(), false, false);
+  tgfx::Pixmap pixmap(bitmap);
+  std::vector<int> indices = {};
+  auto success = decoder->readFrames(
+      0, decoder->numFrames(), pixmap.rowBytes(),
+      [&](int index, const void* pixels) {
+        indices.push_back(index);
+        if (index == 50) {
+          memcpy(pixmap.writablePixels(), pixels, pixmap.byteSize());
+        }
+        return true;
+      },
+      4);
+  EXPECT_TRUE(success);
+  ASSERT_EQ(indices.size(), static_cast<size_t>(decoder->numFrames()));
+  for (size_t i = 0; i < indices.size(); i++) {
+    EXPECT_EQ(indices[i], static_cast<int>(i));
+  }
+  EXPECT_TRUE(Baseline::Compare(pixmap, "PAGDiskCacheTest/decoder_frame_50"));
+  EXPECT_TRUE(decoder->sequenceFile->isComplete());
+  EXPECT_TRUE(decoder->workerReaders.empty());
+
+  indices.clear();
+  success = decoder->readFrames(10, 20, pixmap.rowBytes(), [&](int index, const void*) {
+    indices.push_back(index);
+    return index < 14;
+  });
+  EXPECT_TRUE(success);
+  EXPECT_EQ(indices.size(), 5u);
+  success = decoder->readFrames(
+      20, 10, pixmap.rowBytes(), [](int, const void*) { return true; }, 4);
+  EXPECT_FALSE(success);
+  decoder = nullptr;
+  pag::PAGDiskCache::RemoveAll();
+}
+
 PAG_TEST(PAGDiskCacheTest, FileCache) {
   pag::PAGDiskCache::RemoveAll();
   auto data = ReadFile("resources/apitest/polygon.pag");
@@ -16,7 +16,13 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <thread>
+#include "base/keyframes/SingleEaseKeyframe.h"
 #include "base/utils/TimeUtil.h"
+#include "codec/CodecContext.h"
+#include "codec/TagHeader.h"
+#include "codec/utils/DecodeStream.h"
+#include "codec/utils/EncodeStream.h"
 #include "nlohmann/json.hpp"
 #include "utils/TestUtils.h"
 
@@ -127,6 +133,46 @@ PAG_TEST(PAGFileTest, TestPAGFileEncodeDecode) {
   }
 }
 
+/**
+ * 用例描述: PAGBatchRenderer 批量替换渲染
+ */
+PAG_TEST(PAGFileTest, TestPAGBatchRenderer) {
+  PAG_SETUP(TestPAGSurface, TestPAGPlayer, TestPAGFile);
+  ASSERT_NE(TestPAGFile, nullptr);
+  auto surface = OffscreenSurface::Make(TestPAGFile->width(), TestPAGFile->height());
+  auto renderer = PAGBatchRenderer::Make(TestPAGFile->getFile(), surface);
+  ASSERT_NE(renderer, nullptr);
+  EXPECT_EQ(renderer->getSurface(), surface);
+  EXPECT_EQ(renderer->numFrames(), 250);
+
+  std::vector<PAGReplacementSet> replacementSets(3);
+  auto textData = TestPAGFile->getTextData(0);
+  textData->text = "batch";
+  replacementSets[0].texts[0] = textData;
+  replacementSets[1].texts[0] = textData;
+  replacementSets[1].images[0] = MakePAGImage("resources/apitest/imageReplacement.png");
+  std::vector<int> frameCounts(replacementSets.size(), 0);
+  auto success = renderer->render(replacementSets, [&](size_t setIndex, int) {
+    frameCounts[setIndex]++;
+    return true;
+  });
+  EXPECT_TRUE(success);
+  for (auto frameCount : frameCounts) {
+    EXPECT_EQ(frameCount, 250);
+  }
+  auto pagFile = renderer->pagFile;
+  auto textLayer = std::static_pointer_cast<PAGTextLayer>(
+      pagFile->getLayersByEditableIndex(0, LayerType::Text)[0]);
+  EXPECT_EQ(textLayer->text(), TestPAGFile->getTextData(0)->text);
+  auto imageLayer = std::static_pointer_cast<PAGImageLayer>(
+      pagFile->getLayersByEditableIndex(0, LayerType::Image)[0]);
+  EXPECT_FALSE(imageLayer->hasPAGImage());
+
+  success = renderer->render(replacementSets, [](size_t, int frame) { return frame < 10; });
+  EXPECT_FALSE(success);
+  EXPECT_EQ(textLayer->text(), "batch");
+}
+
 /**
  * 用例描述: PAGFile numImages 接口
  */
@@ -321,6 +367,24 @@ PAG_TEST(PAGFileLoadTest, byteData) {
   ASSERT_TRUE(byteData->length() != 0);
 }
 
+/**
+ * 用例描述: ByteData 内存映射测试
+ */
+PAG_TEST(PAGFileLoadTest, byteDataMapped) {
+  auto filePath = ProjectPath::Absolute("resources/apitest/test.pag");
+  auto byteData = ByteData::FromPath(filePath);
+  ASSERT_TRUE(byteData != nullptr);
+  auto mappedData = ByteData::FromPathMapped(filePath);
+  ASSERT_TRUE(mappedData != nullptr);
+  ASSERT_EQ(mappedData->length(), byteData->length());
+  EXPECT_EQ(memcmp(mappedData->data(), byteData->data(), byteData->length()), 0);
+  EXPECT_TRUE(ByteData::FromPathMapped(filePath + ".notfound") == nullptr);
+
+  auto file = File::Load(filePath);
+  ASSERT_TRUE(file != nullptr);
+  EXPECT_EQ(File::Load(filePath), file);
+}
+
 /**
  * 用例描述: PAGFile解码测试
  */
@@ -718,4 +782,228 @@ PAG_TEST(PAGFileTest, EditableIndices) {
   ASSERT_EQ(editableTexts[1], static_cast<int>(0));
 }
 
+/**
+ * 用例描述: DecodeStream 按位读取的列表与 EncodeStream 写入的数据一致，包括跨越数据末尾的情况
+ */
+PAG_TEST(PAGFileTest, BitPackedLists) {
+  StreamContext context = {};
+  EncodeStream encodeStream(&context);
+  std::vector<int32_t> intValues = {0, -1, 1, 123456, -654321, 7, -8, 1 << 20};
+  std::vector<float> floatValues = {0.0f, 1.5f, -2.25f, 1024.75f, -0.5f};
+  std::vector<Point> points = {{1.0f, -1.0f}, {300.5f, 20.25f}, {-77.0f, 0.0f}};
+  encodeStream.writeUBits(5, 3);  // Misaligns the lists.
+  encodeStream.writeInt32List(intValues.data(), static_cast<uint32_t>(intValues.size()));
+  encodeStream.writeFloatList(floatValues.data(), static_cast<uint32_t>(floatValues.size()), 0.05f);
+  encodeStream.writePoint2DList(points.data(), static_cast<uint32_t>(points.size()), 0.05f);
+  auto bytes = encodeStream.release();
+  ASSERT_NE(bytes, nullptr);
+
+  DecodeStream decodeStream(&context, bytes->data(), static_cast<uint32_t>(bytes->length()));
+  EXPECT_EQ(decodeStream.readUBits(3), 5u);
+  std::vector<int32_t> intResults(intValues.size());
+  decodeStream.readInt32List(intResults.data(), static_cast<uint32_t>(intResults.size()));
+  EXPECT_EQ(intResults, intValues);
+  std::vector<float> floatResults(floatValues.size());
+  decodeStream.readFloatList(floatResults.data(), static_cast<uint32_t>(floatResults.size()),
+                             0.05f);
+  for (size_t i = 0; i < floatValues.size(); i++) {
+    EXPECT_NEAR(floatResults[i], floatValues[i], 0.001f);
+  }
+  std::vector<Point> pointResults(points.size());
+  decodeStream.readPoint2DList(pointResults.data(), static_cast<uint32_t>(pointResults.size()),
+                               0.05f);
+  for (size_t i = 0; i < points.size(); i++) {
+    EXPECT_NEAR(pointResults[i].x, points[i].x, 0.001f);
+    EXPECT_NEAR(pointResults[i].y, points[i].y, 0.001f);
+  }
+  EXPECT_FALSE(context.hasException());
+
+  // Reading a list past the end of the data reports an error instead of crashing.
+  DecodeStream truncatedStream(&context, bytes->data(), 2);
+  truncatedStream.readUBits(3);
+  truncatedStream.readInt32List(intResults.data(), static_cast<uint32_t>(intResults.size()));
+  EXPECT_TRUE(context.hasException());
+}
+
+/**
+ * 用例描述: 并行解码文件中的图片和合成，结果与串行解码一致
+ */
+PAG_TEST(PAGFileTest, ParallelDecoding) {
+  auto path = ProjectPath::Absolute("resources/apitest/complex_test.pag");
+  auto byteData = ByteData::FromPath(path);
+  ASSERT_NE(byteData, nullptr);
+  auto serialFile = Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), "");
+  ASSERT_NE(serialFile, nullptr);
+  ScopedSetting restoreParallelDecoding([]() { Codec::SetParallelDecodingEnabled(false); });
+  Codec::SetParallelDecodingEnabled(true);
+  auto parallelFile =
+      Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), "");
+  ASSERT_NE(parallelFile, nullptr);
+  ASSERT_EQ(serialFile->compositions.size(), parallelFile->compositions.size());
+  ASSERT_EQ(serialFile->images.size(), parallelFile->images.size());
+  EXPECT_EQ(serialFile->tagLevel(), parallelFile->tagLevel());
+  EXPECT_EQ(serialFile->getRootLayer()->composition->id,
+            parallelFile->getRootLayer()->composition->id);
+  auto serialEncoded = Codec::Encode(serialFile);
+  auto parallelEncoded = Codec::Encode(parallelFile);
+  ASSERT_EQ(serialEncoded->length(), parallelEncoded->length());
+  EXPECT_EQ(memcmp(serialEncoded->data(), parallelEncoded->data(), serialEncoded->length()), 0);
+}
+
+/**
+ * 用例描述: 并行解码时合成内部的解码错误会传递出来，与串行解码一样返回 nullptr
+ */
+PAG_TEST(PAGFileTest, ParallelDecodingError) {
+  auto path = ProjectPath::Absolute("resources/apitest/complex_test.pag");
+  auto byteData = ByteData::FromPath(path);
+  ASSERT_NE(byteData, nullptr);
+  // 文件头依次为 "PAG"、版本号、body 长度和压缩方式，共 9 个字节，之后是顶层的 tag 列表。
+  const uint32_t fileHeaderSize = 9;
+  CodecContext context = {};
+  DecodeStream stream(&context, byteData->data(), static_cast<uint32_t>(byteData->length()));
+  stream.skip(fileHeaderSize);
+  uint32_t tagStart = 0;
+  TagHeader header = {};
+  while (stream.bytesAvailable() > 0) {
+    tagStart = stream.position();
+    header = ReadTagHeader(&stream);
+    ASSERT_FALSE(context.hasException());
+    if (header.code == TagCode::End || header.code == TagCode::VectorCompositionBlock) {
+      break;
+    }
+    stream.skip(header.length);
+  }
+  ASSERT_EQ(header.code, TagCode::VectorCompositionBlock);
+  // 保持顶层 tag 结构完整，只把第一个合成 tag 的内容截掉一半，使合成内部读取越界。
+  auto bodyStart = stream.position();
+  auto truncatedLength = header.length / 2;
+  auto truncatedBody = ByteData::MakeCopy(byteData->data() + bodyStart, truncatedLength);
+  CodecContext encodeContext = {};
+  EncodeStream encoder(&encodeContext);
+  encoder.writeBytes(byteData->data(), tagStart);
+  WriteTagHeader(&encoder, truncatedBody.get(), TagCode::VectorCompositionBlock);
+  auto restStart = bodyStart + header.length;
+  encoder.writeBytes(byteData->data() + restStart,
+                     static_cast<uint32_t>(byteData->length()) - restStart);
+  auto corrupted = encoder.release();
+
+  auto serialFile =
+      Codec::Decode(corrupted->data(), static_cast<uint32_t>(corrupted->length()), "");
+  EXPECT_EQ(serialFile, nullptr);
+  ScopedSetting restoreParallelDecoding([]() { Codec::SetParallelDecodingEnabled(false); });
+  Codec::SetParallelDecodingEnabled(true);
+  auto parallelFile =
+      Codec::Decode(corrupted->data(), static_cast<uint32_t>(corrupted->length()), "");
+  EXPECT_EQ(parallelFile, nullptr);
+}
+
+/**
+ * 用例描述: 关键帧二分查找和缓动缓存表的结果与直接插值一致，并支持多线程同时求值
+ */
+PAG_TEST(PAGFileTest, KeyframeLookup) {
+  // 最后一个关键帧的时长超过 EasingTable::MaxFrameCount，覆盖不缓存的路径。
+  std::vector<Frame> times = {10, 40, 45, 120, 500};
+  std::vector<Keyframe<float>*> keyframes = {};
+  for (size_t i = 0; i < times.size() - 1; i++) {
+    auto keyframe = new SingleEaseKeyframe<float>();
+    keyframe->startTime = times[i];
+    keyframe->endTime = times[i + 1];
+    keyframe->startValue = static_cast<float>(i * 100);
+    keyframe->endValue = static_cast<float>((i + 1) * 100);
+    keyframe->interpolationType = KeyframeInterpolationType::Bezier;
+    keyframe->bezierOut.push_back(Point::Make(0.3f, 0.1f * static_cast<float>(i)));
+    keyframe->bezierIn.push_back(Point::Make(0.7f, 1.0f));
+    keyframes.push_back(keyframe);
+  }
+  AnimatableProperty<float> property(keyframes);
+  std::vector<float> expected = {};
+  for (Frame frame = 0; frame < 520; frame++) {
+    float value = 0;
+    if (frame <= times.front()) {
+      value = keyframes.front()->startValue;
+    } else if (frame >= times.back()) {
+      value = keyframes.back()->endValue;
+    } else {
+      auto index = std::upper_bound(times.begin(), times.end(), frame) - times.begin() - 1;
+      auto keyframe = keyframes[index];
+      BezierEasing easing(keyframe->bezierOut[0], keyframe->bezierIn[0]);
+      auto progress = static_cast<float>(frame - keyframe->startTime) /
+                      static_cast<float>(keyframe->endTime - keyframe->startTime);
+      value = Interpolate(keyframe->startValue, keyframe->endValue,
+                          easing.getInterpolation(progress));
+    }
+    expected.push_back(value);
+  }
+  for (Frame frame = 0; frame < 520; frame++) {
+    EXPECT_FLOAT_EQ(property.getValueAt(frame), expected[frame]);
+  }
+  for (Frame frame = 519; frame >= 0; frame--) {
+    EXPECT_FLOAT_EQ(property.getValueAt(frame), expected[frame]);
+  }
+  std::atomic_int mismatchCount = {0};
+  std::vector<std::thread> threads = {};
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&, i]() {
+      for (int step = 0; step < 2000; step++) {
+        auto frame = static_cast<Frame>((step * 37 + i * 101) % 520);
+        if (property.getValueAt(frame) != expected[frame]) {
+          mismatchCount++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(mismatchCount, 0);
+}
+
+/**
+ * 用例描述: 多个线程同时渲染同一个 File 的不同帧，结果与单线程渲染一致
+ */
+PAG_TEST(PAGFileTest, ConcurrentRender) {
+  auto path = ProjectPath::Absolute("resources/apitest/complex_test.pag");
+  auto byteData = ByteData::FromPath(path);
+  ASSERT_NE(byteData, nullptr);
+  auto sharedFile = Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), "");
+  auto serialFile = Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), "");
+  ASSERT_NE(sharedFile, nullptr);
+  ASSERT_NE(serialFile, nullptr);
+  auto renderFrame = [](std::shared_ptr<File> file, Frame frame) {
+    auto pagFile = PAGFile::MakeFrom(std::move(file));
+    auto surface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+    auto player = std::make_shared<PAGPlayer>();
+    player->setSurface(surface);
+    player->setComposition(pagFile);
+    auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+    player->setProgress(FrameToProgress(frame, totalFrames));
+    player->flush();
+    auto rowBytes = static_cast<size_t>(surface->width()) * 4;
+    std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(surface->height()));
+    surface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied, pixels.data(), rowBytes);
+    return pixels;
+  };
+  constexpr int ThreadCount = 4;
+  constexpr int FramesPerThread = 3;
+  std::vector<std::vector<uint8_t>> results(ThreadCount * FramesPerThread);
+  std::vector<std::thread> threads = {};
+  for (int i = 0; i < ThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < FramesPerThread; j++) {
+        auto index = i * FramesPerThread + j;
+        results[index] = renderFrame(sharedFile, index * 7);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int index = 0; index < ThreadCount * FramesPerThread; index++) {
+    auto expected = renderFrame(serialFile, index * 7);
+    ASSERT_EQ(results[index].size(), expected.size());
+    EXPECT_EQ(memcmp(results[index].data(), expected.data(), expected.size()), 0)
+        << "frame " << index * 7;
+  }
+}
+
 }  // namespace pag
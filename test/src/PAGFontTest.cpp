@@ -20,6 +20,7 @@
 #include <vector>
 #include "base/utils/TimeUtil.h"
 #include "nlohmann/json.hpp"
+#include "rendering/utils/shaper/TextShaper.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -58,4 +59,99 @@ PAG_TEST(PAGFontTest, TestFont) {
   EXPECT_EQ(errorMsg, "") << "test_font frame fail";
 }
 
+static bool SameGlyphs(const PositionedGlyphs& first, const PositionedGlyphs& second) {
+  if (first.glyphCount() != second.glyphCount()) {
+    return false;
+  }
+  for (size_t i = 0; i < first.glyphCount(); i++) {
+    if (first.getTypeface(i) != second.getTypeface(i) ||
+        first.getGlyphID(i) != second.getGlyphID(i) ||
+        first.getStringIndex(i) != second.getStringIndex(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * 用例描述: 重复排版相同文本时命中排版结果缓存，超过容量时淘汰最久未使用的结果，清理缓存前后排版结果一致
+ */
+PAG_TEST(PAGFontTest, ShapedTextCache) {
+  if (TextShaper::ShapedTextCacheCapacity() == 0) {
+    GTEST_SKIP() << "The text is not shaped by HarfBuzz on this platform.";
+  }
+  auto typeface =
+      tgfx::Typeface::MakeFromPath(ProjectPath::Absolute("resources/font/NotoSansSC-Regular.otf"));
+  ASSERT_NE(typeface, nullptr);
+  TextShaper::PurgeCaches();
+  EXPECT_EQ(TextShaper::ShapedTextCacheSize(), 0u);
+  std::string text = "Hello 世界";
+  auto glyphs = TextShaper::Shape(text, typeface);
+  ASSERT_GT(glyphs.glyphCount(), 0u);
+  EXPECT_EQ(TextShaper::ShapedTextCacheSize(), 1u);
+  auto hitCount = TextShaper::ShapedTextCacheHitCount();
+  auto cachedGlyphs = TextShaper::Shape(text, typeface);
+  EXPECT_EQ(TextShaper::ShapedTextCacheHitCount(), hitCount + 1);
+  EXPECT_TRUE(SameGlyphs(glyphs, cachedGlyphs));
+
+  auto capacity = TextShaper::ShapedTextCacheCapacity();
+  for (size_t i = 0; i < capacity; i++) {
+    TextShaper::Shape(std::to_string(i), typeface);
+  }
+  EXPECT_EQ(TextShaper::ShapedTextCacheSize(), capacity);
+  hitCount = TextShaper::ShapedTextCacheHitCount();
+  auto reshapedGlyphs = TextShaper::Shape(text, typeface);
+  EXPECT_EQ(TextShaper::ShapedTextCacheHitCount(), hitCount);
+  EXPECT_TRUE(SameGlyphs(glyphs, reshapedGlyphs));
+
+  TextShaper::PurgeCaches();
+  EXPECT_EQ(TextShaper::ShapedTextCacheSize(), 0u);
+  auto purgedGlyphs = TextShaper::Shape(text, typeface);
+  EXPECT_TRUE(SameGlyphs(glyphs, purgedGlyphs));
+}
+
+/**
+ * 用例描述: SetMaxShapingFontCount 限制 HarfBuzz 字体缓存的总数，设为 0 时关闭缓存，被淘汰的字体再次排版时重新创建
+ */
+PAG_TEST(PAGFontTest, ShapingFontCache) {
+  if (PAGFont::MaxShapingFontCount() == 0) {
+    GTEST_SKIP() << "The text is not shaped by HarfBuzz on this platform.";
+  }
+  auto maxFontCount = PAGFont::MaxShapingFontCount();
+  ScopedSetting restoreFontCount(
+      [maxFontCount]() { PAGFont::SetMaxShapingFontCount(maxFontCount); });
+  PAGFont::SetMaxShapingFontCount(8);
+  EXPECT_EQ(PAGFont::MaxShapingFontCount(), 8u);
+  TextShaper::PurgeCaches();
+  auto fontPath = ProjectPath::Absolute("resources/font/NotoSansSC-Regular.otf");
+  std::vector<std::shared_ptr<tgfx::Typeface>> typefaces = {};
+  for (int i = 0; i < 32; i++) {
+    // 每次从路径创建的 Typeface 都有独立的 uniqueID，各自对应一个 HarfBuzz 字体。
+    auto typeface = tgfx::Typeface::MakeFromPath(fontPath);
+    ASSERT_NE(typeface, nullptr);
+    EXPECT_GT(TextShaper::Shape("PAG", typeface).glyphCount(), 0u);
+    EXPECT_LE(TextShaper::FontCacheSize(), 8u);
+    typefaces.push_back(typeface);
+  }
+  EXPECT_EQ(TextShaper::FontCacheSize(), 8u);
+  TextShaper::PurgeCaches();
+  auto missCount = TextShaper::FontCacheMissCount();
+  for (auto& typeface : typefaces) {
+    TextShaper::Shape("PAG", typeface);
+  }
+  EXPECT_EQ(TextShaper::FontCacheMissCount(), missCount + typefaces.size());
+  EXPECT_EQ(TextShaper::FontCacheSize(), 8u);
+  // 调小上限时立即淘汰多余的字体。
+  PAGFont::SetMaxShapingFontCount(1);
+  EXPECT_EQ(TextShaper::FontCacheSize(), 1u);
+  EXPECT_GT(TextShaper::Shape("PAG Font", typefaces[0]).glyphCount(), 0u);
+  EXPECT_EQ(TextShaper::FontCacheSize(), 1u);
+  // 上限为 0 时不再缓存任何字体。
+  PAGFont::SetMaxShapingFontCount(0);
+  EXPECT_EQ(TextShaper::FontCacheSize(), 0u);
+  EXPECT_GT(TextShaper::Shape("PAG Font", typefaces[1]).glyphCount(), 0u);
+  EXPECT_EQ(TextShaper::FontCacheSize(), 0u);
+  TextShaper::PurgeCaches();
+}
+
 }  // namespace pag
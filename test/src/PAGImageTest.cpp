@@ -16,9 +16,12 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <filesystem>
 #include <thread>
 #include "nlohmann/json.hpp"
 #include "pag/pag.h"
+#include "rendering/editing/AnimatedImage.h"
+#include "rendering/editing/ImageReplacement.h"
 #include "tgfx/core/ImageCodec.h"
 #include "tgfx/gpu/Surface.h"
 #include "tgfx/opengl/GLDevice.h"
@@ -164,4 +167,58 @@ PAG_TEST(PAGImageTest, BottomLeftMask) {
   device->unlock();
   EXPECT_TRUE(Baseline::Compare(pixmap, "PAGImageTest/BottomLeftMask"));
 }
+/**
+ * 用例描述: 图片序列创建的动态PAGImage替换图片图层，按图层的时间重映射逐帧解码和渲染
+ */
+PAG_TEST(PAGImageTest, AnimatedImage) {
+  auto directory = (std::filesystem::temp_directory_path() / "PAGImageTest_AnimatedImage").string();
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  auto imagePath = ProjectPath::Absolute("resources/apitest/imageReplacement.png");
+  for (int i = 0; i < 4; i++) {
+    std::filesystem::copy_file(imagePath, directory + "/frame_" + std::to_string(i) + ".png");
+  }
+  EXPECT_EQ(PAGImage::FromImageSequence(directory + "/none", 10), nullptr);
+  EXPECT_EQ(PAGImage::FromImageSequence(directory, 0), nullptr);
+  auto pagImage = PAGImage::FromImageSequence(directory, 10);
+  ASSERT_TRUE(pagImage != nullptr);
+  EXPECT_EQ(pagImage->width(), 110);
+  EXPECT_EQ(pagImage->height(), 110);
+  EXPECT_FALSE(pagImage->isStill());
+  EXPECT_EQ(pagImage->getContentFrame(0), 0);
+  EXPECT_EQ(pagImage->getContentFrame(150000), 1);
+  EXPECT_EQ(pagImage->getContentFrame(10000000), 3);
+  EXPECT_EQ(pagImage->getContentFrame(-100000), 0);
+
+  auto pagFile = LoadPAGFile("resources/apitest/replace2.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  pagFile->replaceImage(0, pagImage);
+  auto imageLayer = std::static_pointer_cast<PAGImageLayer>(
+      pagFile->getLayersByEditableIndex(0, LayerType::Image).front());
+  ASSERT_TRUE(imageLayer->replacement != nullptr);
+  auto surface = OffscreenSurface::Make(720, 720);
+  ASSERT_TRUE(surface != nullptr);
+  auto player = std::make_unique<PAGPlayer>();
+  player->setComposition(pagFile);
+  player->setSurface(surface);
+  auto animatedImage = static_cast<AnimatedImage*>(pagImage.get());
+  for (auto progress : {0.0, 0.5, 0.25}) {
+    player->setProgress(progress);
+    EXPECT_TRUE(player->flush());
+    auto contentFrame = imageLayer->replacement->contentFrame;
+    EXPECT_GE(contentFrame, 0);
+    EXPECT_LE(contentFrame, 3);
+    if (animatedImage->currentFrame >= 0) {
+      // The image is decoded only if the layer is visible at the current time.
+      EXPECT_EQ(animatedImage->currentFrame, contentFrame);
+      EXPECT_EQ(animatedImage->prefetchedFrames.empty(), contentFrame == 3);
+    }
+  }
+  // 动态图片只有一个解码器，并行导出时不复制 PAGFile，回退为逐帧渲染。
+  EXPECT_EQ(pagFile->copyWithEdits(), nullptr);
+  player = nullptr;
+  pagFile = nullptr;
+  pagImage = nullptr;
+  std::filesystem::remove_all(directory);
+}
 }  // namespace pag
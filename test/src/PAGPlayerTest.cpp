@@ -16,7 +16,10 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include "base/utils/TimeUtil.h"
 #include "nlohmann/json.hpp"
+#include "rendering/caches/FrameCache.h"
+#include "rendering/caches/LayerCache.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -129,4 +132,168 @@ PAG_TEST(PAGPlayerTest, autoClear) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGPlayerTest/autoClear_autoClear_true"));
 }
 
-}  // namespace pag
\ No newline at end of file
+/**
+ * 用例描述: 设置帧缓存内存上限后，顺序渲染时每个图层只保留最近的帧
+ */
+PAG_TEST(PAGPlayerTest, frameCacheBudget) {
+  auto maxCacheMemory = PAGFrameCache::MaxCacheMemory();
+  auto maxTotalMemory = PAGFrameCache::MaxTotalMemory();
+  ScopedSetting restoreBudget([maxCacheMemory, maxTotalMemory]() {
+    PAGFrameCache::SetMaxCacheMemory(maxCacheMemory);
+    PAGFrameCache::SetMaxTotalMemory(maxTotalMemory);
+  });
+  PAGFrameCache::SetMaxCacheMemory(1);
+  auto pagFile = LoadPAGFile("resources/apitest/ZC2.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  auto totalFrames = TimeToFrame(pagFile->duration(), pagFile->frameRate());
+  for (int i = 0; i < totalFrames; i++) {
+    pagPlayer->setProgress((i + 0.1) / totalFrames);
+    pagPlayer->flush();
+  }
+  // 每帧结束后释放固定的缓存，不会随渲染帧数增长。
+  EXPECT_EQ(FrameCachePins::PinnedCount(), 0u);
+  auto layers = pagFile->getLayersBy([](PAGLayer*) { return true; });
+  ASSERT_FALSE(layers.empty());
+  for (auto& layer : layers) {
+    auto layerCache = layer->layerCache;
+    EXPECT_LE(layerCache->transformCache->frames.size(), 2u);
+    EXPECT_LE(layerCache->contentCache->frames.size(), 2u);
+  }
+  EXPECT_GT(PAGFrameCache::TotalMemory(), 0u);
+  {
+    FrameCachePins framePins = {};
+    auto layerCache = layers.front()->layerCache;
+    for (int i = 0; i < 10; i++) {
+      layerCache->getTransform(0);
+    }
+    EXPECT_EQ(FrameCachePins::PinnedCount(), 1u);
+  }
+  EXPECT_EQ(FrameCachePins::PinnedCount(), 0u);
+  // 不在任何 FrameCachePins 范围内时不固定缓存。
+  layers.front()->layerCache->getTransform(1);
+  EXPECT_EQ(FrameCachePins::PinnedCount(), 0u);
+  // 查询包围盒、矩阵和点击测试时同样在 FrameCachePins 范围内读取缓存，结束后释放。
+  for (auto& layer : layers) {
+    pagPlayer->getBounds(layer);
+    layer->getBounds();
+    layer->getTotalMatrix();
+    pagPlayer->hitTestPoint(layer, 10, 10);
+  }
+  pagPlayer->getLayersUnderPoint(10, 10);
+  EXPECT_EQ(FrameCachePins::PinnedCount(), 0u);
+  for (auto& layer : layers) {
+    auto layerCache = layer->layerCache;
+    EXPECT_LE(layerCache->transformCache->frames.size(), 2u);
+    EXPECT_LE(layerCache->contentCache->frames.size(), 2u);
+  }
+}
+
+/**
+ * 用例描述: PAGPlayer 显存上限和主动清理缓存
+ */
+PAG_TEST(PAGPlayerTest, memoryLimits) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  EXPECT_EQ(pagPlayer->softMemoryLimit(), PAGGraphicsMemory::DefaultSoftLimit());
+  EXPECT_EQ(pagPlayer->hardMemoryLimit(), PAGGraphicsMemory::DefaultHardLimit());
+  pagPlayer->flush();
+  auto memoryUsage = static_cast<size_t>(pagPlayer->graphicsMemory());
+  EXPECT_GE(PAGGraphicsMemory::TotalMemory(), memoryUsage);
+  EXPECT_GE(pagPlayer->purgeCache(memoryUsage), memoryUsage);
+  EXPECT_EQ(pagPlayer->graphicsMemory(), 0);
+
+  int pressureCount = 0;
+  pagPlayer->setMemoryPressureCallback([&pressureCount](size_t) { pressureCount++; });
+  pagPlayer->setProgress(0.2);
+  pagPlayer->flush();
+  EXPECT_EQ(pressureCount, 0);
+
+  // 超过软限制时通知内存压力回调。
+  pagPlayer->setSoftMemoryLimit(1);
+  pagPlayer->setProgress(0.4);
+  pagPlayer->flush();
+  EXPECT_EQ(pressureCount, 1);
+
+  // 硬限制下帧结束时不保留任何缓存。
+  pagPlayer->setHardMemoryLimit(1);
+  pagPlayer->setProgress(0.6);
+  pagPlayer->flush();
+  EXPECT_EQ(pagPlayer->graphicsMemory(), 0);
+  EXPECT_EQ(pressureCount, 2);
+
+  pagPlayer->setSurface(nullptr);
+  EXPECT_EQ(pagPlayer->purgeCache(memoryUsage), 0u);
+}
+
+/**
+ * 用例描述: 开启增量渲染后只重绘发生变化的区域，结果与整体重绘一致
+ */
+PAG_TEST(PAGPlayerTest, incrementalRendering) {
+  auto pagFile = LoadPAGFile("resources/apitest/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto solidLayer = PAGSolidLayer::Make(pagFile->duration(), 20, 20, Red);
+  pagFile->addLayer(solidLayer);
+  auto pagSurface = OffscreenSurface::Make(width, height);
+  auto pagPlayer = std::make_unique<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  EXPECT_FALSE(pagPlayer->incrementalRendering());
+  pagPlayer->setIncrementalRendering(true);
+  EXPECT_TRUE(pagPlayer->incrementalRendering());
+  ASSERT_TRUE(pagPlayer->flush());
+  auto surfaceBounds = Rect::MakeWH(width, height);
+  EXPECT_TRUE(pagSurface->damagedBounds() == surfaceBounds);
+  EXPECT_FALSE(pagPlayer->flush());
+
+  solidLayer->setMatrix(Matrix::MakeTrans(30, 30));
+  ASSERT_TRUE(pagPlayer->flush());
+  auto damagedBounds = pagSurface->damagedBounds();
+  EXPECT_FALSE(damagedBounds.isEmpty());
+  EXPECT_TRUE(damagedBounds.contains(Rect::MakeXYWH(0, 0, 50, 50)));
+  EXPECT_LT(damagedBounds.width() * damagedBounds.height(),
+            surfaceBounds.width() * surfaceBounds.height());
+
+  auto copyFile = LoadPAGFile("resources/apitest/test.pag");
+  auto copyLayer = PAGSolidLayer::Make(copyFile->duration(), 20, 20, Red);
+  copyLayer->setMatrix(Matrix::MakeTrans(30, 30));
+  copyFile->addLayer(copyLayer);
+  auto copySurface = OffscreenSurface::Make(width, height);
+  auto copyPlayer = std::make_unique<PAGPlayer>();
+  copyPlayer->setSurface(copySurface);
+  copyPlayer->setComposition(copyFile);
+  ASSERT_TRUE(copyPlayer->flush());
+  EXPECT_TRUE(copySurface->damagedBounds() == surfaceBounds);
+
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  std::vector<uint8_t> pixels(rowBytes * static_cast<size_t>(height));
+  std::vector<uint8_t> expected(pixels.size());
+  ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                     pixels.data(), rowBytes));
+  ASSERT_TRUE(copySurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                      expected.data(), rowBytes));
+  EXPECT_EQ(memcmp(pixels.data(), expected.data(), pixels.size()), 0);
+
+  auto left = static_cast<int>(damagedBounds.left);
+  auto top = static_cast<int>(damagedBounds.top);
+  auto damagedWidth = static_cast<int>(damagedBounds.width());
+  auto damagedHeight = static_cast<int>(damagedBounds.height());
+  auto damagedRowBytes = static_cast<size_t>(damagedWidth) * 4;
+  std::vector<uint8_t> damagedPixels(damagedRowBytes * static_cast<size_t>(damagedHeight));
+  ASSERT_TRUE(pagSurface->readPixels(ColorType::RGBA_8888, AlphaType::Premultiplied,
+                                     damagedPixels.data(), damagedRowBytes, damagedBounds));
+  for (int y = 0; y < damagedHeight; y++) {
+    auto row = expected.data() + static_cast<size_t>(top + y) * rowBytes + left * 4;
+    EXPECT_EQ(memcmp(damagedPixels.data() + y * damagedRowBytes, row, damagedRowBytes), 0);
+  }
+}
+}  // namespace pag
@@ -16,10 +16,14 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include "codec/mp4/MP4BoxHelper.h"
 #include "pag/pag.h"
 #include "platform/swiftshader/NativePlatform.h"
 #include "rendering/caches/RenderCache.h"
+#include "rendering/sequences/ParallelVideoReader.h"
+#include "rendering/sequences/VideoSequenceDemuxer.h"
+#include "rendering/video/MP4Demuxer.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -71,6 +75,40 @@ PAG_TEST(PAGSequenceTest, VideoSequenceAsMask) {
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/VideoSequenceAsMask"));
 }
 
+/**
+ * 用例描述: 多帧预解码时，bitmapSequence和videoSequence的渲染结果与单帧预解码一致
+ */
+PAG_TEST(PAGSequenceTest, SequencePrefetch) {
+  ScopedSetting restoreFrameCount([]() { PAGSequencePrefetch::SetMaxFrameCount(1); });
+  PAGSequencePrefetch::SetMaxFrameCount(4);
+  auto pagFile = LoadPAGFile("resources/apitest/ZC_mg_seky2_landscape.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(0.5);
+  pagPlayer->flush();
+  pagPlayer->nextFrame();
+  pagPlayer->flush();
+  EXPECT_GT(pagPlayer->renderCache->prefetchedFrames, 0);
+  pagPlayer->setProgress(0.75);
+  pagPlayer->flush();
+  EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/BitmapSequenceReader"));
+
+  pagFile = LoadPAGFile("resources/apitest/video_sequence_as_mask.pag");
+  ASSERT_NE(pagFile, nullptr);
+  pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(0.1);
+  pagPlayer->flush();
+  pagPlayer->setProgress(0.2);
+  pagPlayer->flush();
+  EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/VideoSequenceAsMask"));
+}
+
 /**
  * 用例描述: 带mp4头的视频序列帧导出为mp4
  */
@@ -151,4 +189,210 @@ PAG_TEST(PAGSequenceTest, Sequence_Multiple_References) {
   EXPECT_EQ(static_cast<int>(sequenceCaches.begin()->second.size()), 1);
 }
 
+static VideoSequence* GetFirstVideoSequence(const std::shared_ptr<File>& file) {
+  auto composition = file->getRootLayer()->composition;
+  if (composition == nullptr || composition->type() != CompositionType::Video) {
+    return nullptr;
+  }
+  auto& sequences = static_cast<VideoComposition*>(composition)->sequences;
+  return sequences.empty() ? nullptr : sequences[0];
+}
+
+/**
+ * 用例描述: 从共享的文件数据解码时，视频帧直接引用文件数据，编码和导出mp4的结果与拷贝模式一致
+ */
+PAG_TEST(PAGSequenceTest, VideoSequenceZeroCopy) {
+  auto path = ProjectPath::Absolute("resources/apitest/video_sequence_without_mp4header.pag");
+  auto byteData = ByteData::FromPath(path);
+  ASSERT_NE(byteData, nullptr);
+  auto copiedFile = Codec::Decode(byteData->data(), static_cast<uint32_t>(byteData->length()), "");
+  ASSERT_NE(copiedFile, nullptr);
+  std::shared_ptr<ByteData> sharedBytes = ByteData::FromPath(path);
+  ASSERT_NE(sharedBytes, nullptr);
+  auto sharedFile = Codec::Decode(sharedBytes, "");
+  ASSERT_NE(sharedFile, nullptr);
+
+  auto copiedSequence = GetFirstVideoSequence(copiedFile);
+  auto sharedSequence = GetFirstVideoSequence(sharedFile);
+  ASSERT_NE(copiedSequence, nullptr);
+  ASSERT_NE(sharedSequence, nullptr);
+  EXPECT_TRUE(copiedSequence->hasFrameStartCodes);
+  EXPECT_FALSE(sharedSequence->hasFrameStartCodes);
+  ASSERT_EQ(copiedSequence->frames.size(), sharedSequence->frames.size());
+  auto sourceStart = sharedBytes->data();
+  auto sourceEnd = sourceStart + sharedBytes->length();
+  for (size_t i = 0; i < sharedSequence->frames.size(); i++) {
+    auto copiedBytes = copiedSequence->frames[i]->fileBytes;
+    auto sharedFrameBytes = sharedSequence->frames[i]->fileBytes;
+    ASSERT_EQ(copiedBytes->length(), sharedFrameBytes->length() + 4);
+    EXPECT_TRUE(sharedFrameBytes->data() >= sourceStart && sharedFrameBytes->data() < sourceEnd);
+    EXPECT_EQ(memcmp(copiedBytes->data() + 4, sharedFrameBytes->data(), sharedFrameBytes->length()),
+              0);
+  }
+
+  // The decoded file keeps the source bytes alive.
+  EXPECT_GT(sharedBytes.use_count(), 1);
+  sharedBytes = nullptr;
+
+  auto copiedMP4 = MP4BoxHelper::CovertToMP4(copiedSequence);
+  auto sharedMP4 = MP4BoxHelper::CovertToMP4(sharedSequence);
+  ASSERT_NE(copiedMP4, nullptr);
+  ASSERT_NE(sharedMP4, nullptr);
+  ASSERT_EQ(copiedMP4->length(), sharedMP4->length());
+  EXPECT_EQ(memcmp(copiedMP4->data(), sharedMP4->data(), copiedMP4->length()), 0);
+
+  auto copiedEncoded = Codec::Encode(copiedFile);
+  auto sharedEncoded = Codec::Encode(sharedFile);
+  ASSERT_NE(copiedEncoded, nullptr);
+  ASSERT_NE(sharedEncoded, nullptr);
+  ASSERT_EQ(copiedEncoded->length(), sharedEncoded->length());
+  EXPECT_EQ(memcmp(copiedEncoded->data(), sharedEncoded->data(), copiedEncoded->length()), 0);
+}
+
+/**
+ * 用例描述: 按GOP并行解码视频序列帧时，帧按显示顺序返回，渲染结果与逐帧解码一致
+ */
+PAG_TEST(PAGSequenceTest, ParallelVideoReader) {
+  ScopedSetting restoreDecoders([]() {
+    PAGVideoDecoder::SetMaxParallelGOPCount(1);
+    PAGVideoDecoder::SetSoftwareDecoderCoreCount(1);
+  });
+  PAGVideoDecoder::SetMaxParallelGOPCount(3);
+  PAGVideoDecoder::SetSoftwareDecoderCoreCount(2);
+  auto pagFile = LoadPAGFile("resources/apitest/video_sequence_as_mask.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto pagSurface = OffscreenSurface::Make(pagFile->width(), pagFile->height());
+  auto pagPlayer = std::make_shared<PAGPlayer>();
+  pagPlayer->setSurface(pagSurface);
+  pagPlayer->setComposition(pagFile);
+  pagPlayer->setProgress(0.1);
+  pagPlayer->flush();
+  pagPlayer->setProgress(0.2);
+  pagPlayer->flush();
+  EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGSequenceTest/VideoSequenceAsMask"));
+
+  pagFile = LoadPAGFile("resources/apitest/video_sequence_without_mp4header.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto file = pagFile->getFile();
+  auto sequence = GetFirstVideoSequence(file);
+  ASSERT_NE(sequence, nullptr);
+  auto keyframeCount = std::count_if(sequence->frames.begin(), sequence->frames.end(),
+                                     [](VideoFrame* frame) { return frame->isKeyframe; });
+  if (keyframeCount < 2) {
+    GTEST_SKIP() << "The video sequence has only one GOP to decode.";
+  }
+  auto reader = ParallelVideoReader::Make(file, sequence);
+  ASSERT_NE(reader, nullptr);
+  for (Frame frame = 0; frame < sequence->duration(); frame++) {
+    EXPECT_NE(reader->readOwnedBuffer(frame), nullptr);
+  }
+  EXPECT_FALSE(reader->parallelFailed);
+  EXPECT_LE(reader->gopReaders.size(), 3u);
+  auto task = reader->gopTasks.front();
+  EXPECT_EQ(task->index, reader->keyframes.size() - 1);
+  // 已经播放过的帧会被释放，只保留当前帧及之后的帧。
+  ASSERT_EQ(task->releasedFrames, task->buffers.size() - 1);
+  for (size_t i = 0; i < task->releasedFrames; i++) {
+    EXPECT_EQ(task->buffers[i], nullptr);
+  }
+  EXPECT_NE(task->buffers[task->releasedFrames], nullptr);
+  PAGVideoDecoder::SetMaxParallelGOPCount(1);
+  EXPECT_EQ(ParallelVideoReader::Make(file, sequence), nullptr);
+}
+
+/**
+ * 用例描述: 开启视频解码器池后，相同格式的视频序列复用已释放的解码器，并统计命中次数
+ */
+PAG_TEST(PAGSequenceTest, VideoDecoderPool) {
+  ScopedSetting restorePool([]() { PAGVideoDecoder::SetMaxPooledDecoderCount(0); });
+  PAGVideoDecoder::SetMaxPooledDecoderCount(2);
+  auto pagFile = LoadPAGFile("resources/apitest/video_sequence_without_mp4header.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto file = pagFile->getFile();
+  auto sequence = GetFirstVideoSequence(file);
+  ASSERT_NE(sequence, nullptr);
+  auto reader =
+      std::make_shared<VideoReader>(std::make_unique<VideoSequenceDemuxer>(file, sequence));
+  EXPECT_NE(reader->readBuffer(0), nullptr);
+  ASSERT_NE(reader->videoDecoder, nullptr);
+  auto softwareBacked = !reader->videoDecoder->isHardwareBacked();
+  if (softwareBacked) {
+    EXPECT_EQ(reader->pooledDecoderMisses, 1);
+  }
+  reader = std::make_shared<VideoReader>(std::make_unique<VideoSequenceDemuxer>(file, sequence));
+  EXPECT_NE(reader->readBuffer(5), nullptr);
+  if (softwareBacked) {
+    EXPECT_EQ(reader->pooledDecoderHits, 1);
+    EXPECT_EQ(reader->pooledDecoderMisses, 0);
+    Performance performance = {};
+    reader->reportPerformance(&performance);
+    EXPECT_EQ(performance.pooledDecoderHits, 1);
+  }
+  reader = nullptr;
+  PAGVideoDecoder::SetMaxPooledDecoderCount(0);
+  reader = std::make_shared<VideoReader>(std::make_unique<VideoSequenceDemuxer>(file, sequence));
+  EXPECT_NE(reader->readBuffer(0), nullptr);
+  EXPECT_EQ(reader->pooledDecoderHits, 0);
+  EXPECT_EQ(reader->pooledDecoderMisses, 0);
+}
+
+/**
+ * 用例描述: 从视频序列导出的mp4文件中解析H.264视频轨道，并用视频解码器逐帧解码
+ */
+PAG_TEST(PAGSequenceTest, MP4Demuxer) {
+  auto pagFile = LoadPAGFile("resources/apitest/video_sequence_without_mp4header.pag");
+  ASSERT_NE(pagFile, nullptr);
+  auto file = pagFile->getFile();
+  auto sequence = GetFirstVideoSequence(file);
+  ASSERT_NE(sequence, nullptr);
+  auto demuxer = MP4Demuxer::Make(MP4BoxHelper::CovertToMP4(sequence));
+  ASSERT_NE(demuxer, nullptr);
+  EXPECT_EQ(demuxer->sampleCount(), static_cast<int>(sequence->frames.size()));
+  size_t keyframeCount = 0;
+  for (auto& frame : sequence->frames) {
+    if (frame->isKeyframe) {
+      keyframeCount++;
+    }
+  }
+  EXPECT_EQ(demuxer->keyframes.size(), keyframeCount);
+  auto format = demuxer->getFormat();
+  EXPECT_EQ(format.width, sequence->getVideoWidth());
+  EXPECT_EQ(format.height, sequence->getVideoHeight());
+  EXPECT_EQ(format.headers.size(), 2u);
+  EXPECT_EQ(format.demuxer, demuxer.get());
+  EXPECT_EQ(demuxer->sampleTimes.front(), 0);
+  auto sample = demuxer->nextSample();
+  EXPECT_GT(sample.length, 0u);
+  EXPECT_EQ(sample.time, 0);
+  demuxer->reset();
+  EXPECT_EQ(MP4Demuxer::Make(ByteData::Make(64)), nullptr);
+  // 把样本表的条目数改成远超文件长度的值，解析时应直接拒绝而不是按条目数分配内存。
+  auto corruptBox = [&](const char* boxType, uint32_t countOffset, uint32_t sampleSize) {
+    auto mp4Data = MP4BoxHelper::CovertToMP4(sequence);
+    auto bytes = mp4Data->data();
+    auto end = bytes + mp4Data->length();
+    auto box = std::search(bytes, end, boxType, boxType + 4);
+    if (box == end || box + 4 + countOffset + 4 > end) {
+      return mp4Data;
+    }
+    auto fields = box + 4;
+    if (sampleSize != 0) {
+      fields[4] = fields[5] = fields[6] = 0;
+      fields[7] = static_cast<uint8_t>(sampleSize);
+    }
+    memset(fields + countOffset, 0xFF, 4);
+    return mp4Data;
+  };
+  EXPECT_EQ(MP4Demuxer::Make(corruptBox("stsz", 8, 1)), nullptr);
+  EXPECT_EQ(MP4Demuxer::Make(corruptBox("stsz", 8, 0)), nullptr);
+  EXPECT_EQ(MP4Demuxer::Make(corruptBox("stts", 4, 0)), nullptr);
+
+  auto numFrames = demuxer->sampleCount();
+  auto reader = std::make_shared<VideoReader>(std::move(demuxer));
+  for (Frame frame = 0; frame < numFrames; frame++) {
+    EXPECT_NE(reader->readBuffer(frame), nullptr);
+  }
+  EXPECT_NE(reader->readBuffer(0), nullptr);
+}
+
 }  // namespace pag
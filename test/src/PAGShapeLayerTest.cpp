@@ -17,6 +17,7 @@
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include <fstream>
+#include "rendering/caches/PathCache.h"
 #include "utils/TestUtils.h"
 
 namespace pag {
@@ -104,4 +105,32 @@ PAG_TEST(PAGShapeLayerTest, shape_transform_round_corner) {
   pagPlayer->flush();
   EXPECT_TRUE(Baseline::Compare(pagSurface, "PAGShapeLayerTest/shape_transform_round_corner"));
 }
+
+/**
+ * 用例描述: 路径缓存按路径内容和参数命中，超出容量时淘汰最久未使用的结果
+ */
+PAG_TEST(PAGShapeLayerTest, PathCache) {
+  PathCache pathCache(2);
+  tgfx::Path rect = {};
+  rect.addRect(tgfx::Rect::MakeWH(100, 100));
+  tgfx::Path oval = {};
+  oval.addOval(tgfx::Rect::MakeWH(100, 100));
+  PathKey rectKey = {{rect}, {1.0f}};
+  PathKey ovalKey = {{oval}, {1.0f}};
+  std::vector<tgfx::Path> results = {};
+  EXPECT_FALSE(pathCache.find(rectKey, &results));
+  pathCache.add(rectKey, {oval});
+  pathCache.add(ovalKey, {rect});
+  tgfx::Path sameRect = {};
+  sameRect.addRect(tgfx::Rect::MakeWH(100, 100));
+  ASSERT_TRUE(pathCache.find({{sameRect}, {1.0f}}, &results));
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_TRUE(results[0] == oval);
+  EXPECT_FALSE(pathCache.find({{rect}, {2.0f}}, &results));
+  PathKey mixedKey = {{rect, oval}, {}};
+  pathCache.add(mixedKey, {rect});
+  EXPECT_TRUE(pathCache.find(rectKey, &results));
+  EXPECT_FALSE(pathCache.find(ovalKey, &results));
+  EXPECT_TRUE(pathCache.find(mixedKey, &results));
+}
 }  // namespace pag
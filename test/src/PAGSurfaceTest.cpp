@@ -176,4 +176,49 @@ PAG_TEST(PAGSurfaceTest, BottomLeftScissor) {
   gl->deleteTextures(1, &textureInfo.id);
   device->unlock();
 }
+
+/**
+ * 用例描述: PAGSurface 直接渲染到调用方提供的像素缓冲区环，结果与 readPixels 一致
+ */
+PAG_TEST(PAGSurfaceTest, PixelBufferRing) {
+  auto pagFile = LoadPAGFile("assets/test.pag");
+  ASSERT_TRUE(pagFile != nullptr);
+  auto width = pagFile->width();
+  auto height = pagFile->height();
+  auto rowBytes = static_cast<size_t>(width) * 4;
+  auto byteSize = rowBytes * static_cast<size_t>(height);
+  std::vector<std::vector<uint8_t>> storages(2, std::vector<uint8_t>(byteSize));
+  std::vector<void*> buffers = {storages[0].data(), storages[1].data()};
+  std::vector<int> readyIndices = {};
+  auto ringSurface = PAGSurface::MakeOffscreen(width, height, buffers, rowBytes, [&](int index) {
+    readyIndices.push_back(index);
+  });
+  ASSERT_TRUE(ringSurface != nullptr);
+  EXPECT_TRUE(PAGSurface::MakeOffscreen(width, height, {nullptr}, rowBytes, nullptr) == nullptr);
+  EXPECT_TRUE(PAGSurface::MakeOffscreen(width, height, buffers, 1, nullptr) == nullptr);
+  auto ringPlayer = std::make_shared<PAGPlayer>();
+  ringPlayer->setSurface(ringSurface);
+  ringPlayer->setComposition(pagFile);
+
+  auto copyFile = LoadPAGFile("assets/test.pag");
+  auto copySurface = OffscreenSurface::Make(width, height);
+  auto copyPlayer = std::make_shared<PAGPlayer>();
+  copyPlayer->setSurface(copySurface);
+  copyPlayer->setComposition(copyFile);
+  std::vector<uint8_t> expected(byteSize);
+  for (int i = 0; i < 4; i++) {
+    auto progress = i * 0.25;
+    ringPlayer->setProgress(progress);
+    ASSERT_TRUE(ringPlayer->flush());
+    ASSERT_EQ(readyIndices.size(), static_cast<size_t>(i + 1));
+    auto bufferIndex = readyIndices.back();
+    EXPECT_EQ(bufferIndex, i % 2);
+    copyPlayer->setProgress(progress);
+    copyPlayer->flush();
+    copySurface->readPixels(pag::ColorType::RGBA_8888, pag::AlphaType::Premultiplied,
+                            expected.data(), rowBytes);
+    EXPECT_EQ(memcmp(storages[bufferIndex].data(), expected.data(), byteSize), 0);
+    ringSurface->releaseBuffer(bufferIndex);
+  }
+}
 }  // namespace pag
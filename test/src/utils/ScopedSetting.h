@@ -0,0 +1,40 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Tencent is pleased to support the open source community by making libpag available.
+//
+//  Copyright (C) 2023 THL A29 Limited, a Tencent company. All rights reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file
+//  except in compliance with the License. You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  unless required by applicable law or agreed to in writing, software distributed under the
+//  license is distributed on an "as is" basis, without warranties or conditions of any kind,
+//  either express or implied. see the license for the specific language governing permissions
+//  and limitations under the license.
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <functional>
+
+namespace pag {
+/**
+ * ScopedSetting calls the restore function when it goes out of scope, so that a process-wide
+ * setting changed by a test is restored even if the test returns early on a failed assertion.
+ */
+class ScopedSetting {
+ public:
+  explicit ScopedSetting(std::function<void()> restore) : restore(std::move(restore)) {
+  }
+
+  ~ScopedSetting() {
+    restore();
+  }
+
+ private:
+  std::function<void()> restore = nullptr;
+};
+}  // namespace pag
@@ -29,6 +29,7 @@
 #include "utils/Baseline.h"
 #include "utils/OffscreenSurface.h"
 #include "utils/ProjectPath.h"
+#include "utils/ScopedSetting.h"
 #include "utils/Semaphore.h"
 
 namespace pag {